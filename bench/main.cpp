@@ -0,0 +1,514 @@
+/*
+ * Cross-Language Benchmark Suite
+ *
+ * Measures the interop bridge against the pure-local LocalActorRef baseline,
+ * for every message type in interop_messages.h:
+ *
+ *   throughput    one-way sends: C++ -> Rust, Rust -> C++, C++ -> C++
+ *   send_mode     send() vs fast_send() through RustActorIF / CppActorIF, and
+ *                 direct calls to a DirectActor on the sender's thread
+ *   rtt           ping-pong round trips (p50/p99/p99.9): C++ -> Rust -> C++
+ *                 and C++ -> C++
+ *   fanout        one C++ publisher, N Rust subscribers
+ *
+ * Results are written as JSON (stdout, or the file given with --out) so runs
+ * can be compared and gated on regressions. Progress goes to stderr.
+ *
+ * INTEROP_CONFLATE types are conflated on bridge sends, so their bridged
+ * rows time a burst until deliveries stop rather than until every message
+ * has arrived.
+ *
+ * --capture FILE records the suite's bridge traffic (TrafficCapture.hpp);
+ * --replay FILE sends a recorded file again instead of running the suite, at
+ * the recorded pace times --replay-speed (0, the default, is as fast as
+ * possible).
+ *
+ * Usage: bench_interop [--count N] [--fanout-count N] [--rounds N] [--out FILE]
+ *                      [--capture FILE | --replay FILE [--replay-speed X]]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "actors/Actor.hpp"
+#include "actors/ActorRef.hpp"
+#include "InteropMessages.hpp"
+#include "InteropManager.hpp"
+#include "CppActorBridge.hpp"
+#include "InteropShutdown.hpp"
+#include "RustActorIF.hpp"
+#include "TrafficCapture.hpp"
+
+// Rust Manager and benchmark FFI (rust/src/rust_manager_ffi.rs, bench/rust_bench.rs)
+extern "C" {
+    void create_rust_manager();
+    void rust_manager_init();
+    void rust_actor_init(const void* mgr);
+    void init_cpp_actor_lookup();
+
+    int32_t bench_rust_send(const char* target, int32_t msg_type, uint64_t count, int32_t mode);
+    uint64_t bench_rust_received(int32_t index);
+    uint64_t bench_rust_direct_received();
+}
+
+namespace {
+
+constexpr int32_t MAX_FANOUT = 16;  // matches bench::MAX_SINKS
+const int32_t FANOUTS[] = {1, 4, 16};
+
+// bench_rust_send() modes
+constexpr int32_t RUST_ACTOR_REF = 0;
+constexpr int32_t RUST_IF_SEND = 1;
+constexpr int32_t RUST_IF_FAST_SEND = 2;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+/// Spin until get() reaches target; false on timeout
+template <typename Get>
+bool wait_for(Get get, uint64_t target, std::chrono::seconds timeout = std::chrono::seconds(60)) {
+    auto deadline = Clock::now() + timeout;
+    while (get() < target) {
+        if (Clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// How long deliveries must stop for before a conflated burst counts as done
+constexpr uint64_t SETTLE_NS = 20'000'000;
+
+/**
+ * Wait until the messages from a send loop have arrived (get() reaches
+ * target) and return the time they had, or 0 on timeout. A conflated type
+ * may deliver the burst as fewer messages, so there this waits for one more
+ * than `before` and then for deliveries to stop.
+ */
+template <typename Get>
+uint64_t arrived(Get get, uint64_t before, uint64_t target, bool conflated) {
+    if (!conflated) return wait_for(get, target) ? now_ns() : 0;
+    if (!wait_for(get, before + 1)) return 0;
+    uint64_t last = get();
+    uint64_t last_ns = now_ns();
+    while (now_ns() - last_ns < SETTLE_NS) {
+        uint64_t cur = get();
+        if (cur != last) {
+            last = cur;
+            last_ns = now_ns();
+        }
+        std::this_thread::yield();
+    }
+    return last_ns;
+}
+
+/**
+ * BenchDirectSink - counts messages delivered by direct call
+ */
+class BenchDirectSink : public interop::DirectActor {
+public:
+    std::atomic<uint64_t> received{0};
+
+    void on_direct(const interop::MessageView&, int32_t) noexcept override {
+        received.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * BenchSink - counts every message it receives
+ */
+class BenchSink : public actors::Actor {
+public:
+    std::atomic<uint64_t> received{0};
+
+    explicit BenchSink(const char* actor_name) {
+        strncpy(name, actor_name, sizeof(name) - 1);
+#define X(Name, Id) MESSAGE_HANDLER(msg::Name, on_msg<msg::Name>);
+        INTEROP_MESSAGE_LIST(X)
+#undef X
+    }
+
+    template <typename M>
+    void on_msg(const M*) noexcept {
+        received.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * BenchEcho - replies with a copy of every message (local baseline)
+ */
+class BenchEcho : public actors::Actor {
+public:
+    BenchEcho() {
+        strncpy(name, "bench_cpp_echo", sizeof(name) - 1);
+#define X(Name, Id) MESSAGE_HANDLER(msg::Name, on_msg<msg::Name>);
+        INTEROP_MESSAGE_LIST(X)
+#undef X
+    }
+
+    template <typename M>
+    void on_msg(const M* m) noexcept {
+        reply(new M(*m));
+    }
+};
+
+/**
+ * BenchPinger - runs ping-pong rounds against an echo actor and records
+ * each round-trip time. Replies from Rust arrive by name (bench_cpp_pinger).
+ */
+class BenchPinger : public actors::Actor {
+    actors::ActorRef target_;
+    size_t remaining_ = 0;
+    uint64_t sent_at_ = 0;
+    std::vector<uint64_t> samples_;
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+    bool done_ = false;
+
+public:
+    BenchPinger() {
+        strncpy(name, "bench_cpp_pinger", sizeof(name) - 1);
+#define X(Name, Id) MESSAGE_HANDLER(msg::Name, on_msg<msg::Name>);
+        INTEROP_MESSAGE_LIST(X)
+#undef X
+    }
+
+    /// Run `rounds` round trips of M against target; returns the samples (ns)
+    template <typename M>
+    std::vector<uint64_t> run(actors::ActorRef target, size_t rounds) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            target_ = target;
+            remaining_ = rounds;
+            samples_.clear();
+            samples_.reserve(rounds);
+            done_ = false;
+        }
+        sent_at_ = now_ns();
+        target_.send(new M(), this);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!done_cv_.wait_for(lock, std::chrono::seconds(60), [&] { return done_; })) {
+            remaining_ = 0;  // timed out - stop the round
+        }
+        return samples_;
+    }
+
+    template <typename M>
+    void on_msg(const M*) noexcept {
+        uint64_t now = now_ns();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (remaining_ == 0) return;
+        samples_.push_back(now - sent_at_);
+        if (--remaining_ == 0) {
+            done_ = true;
+            done_cv_.notify_one();
+            return;
+        }
+        sent_at_ = now_ns();
+        target_.send(new M(), this);  // replies have the request's type
+    }
+};
+
+/**
+ * Register the Rust benchmark actors by factory: bench_rust_sink_0 ..
+ * bench_rust_sink_{num_sinks-1}, bench_rust_echo, and the direct actor
+ * bench_rust_direct. Returns the Manager pointer for rust_actor_init()
+ */
+const void* register_rust_bench_actors(int32_t num_sinks) {
+    int32_t sink = rust_actor_factory("BenchSink");
+    std::vector<std::string> names;
+    for (int32_t i = 0; i < num_sinks; i++) names.push_back("bench_rust_sink_" + std::to_string(i));
+    std::vector<InteropActorSpec> specs;
+    for (const auto& name : names) specs.push_back({name.c_str(), sink, nullptr});
+    specs.push_back({"bench_rust_echo", rust_actor_factory("BenchEcho"), nullptr});
+    specs.push_back({"bench_rust_direct", rust_actor_factory("BenchDirectSink"), nullptr});
+    return register_rust_actors(specs.data(), specs.size(), nullptr);
+}
+
+class BenchManager : public interop::InteropManager {
+public:
+    BenchSink* sink;
+    BenchPinger* pinger;
+    BenchDirectSink direct_sink;
+
+    BenchManager() {
+        sink = new BenchSink("bench_cpp_sink");
+        pinger = new BenchPinger();
+        manage(sink);
+        manage(new BenchEcho());
+        manage(pinger);
+        interop::register_direct_actor("bench_cpp_direct", &direct_sink);
+    }
+};
+
+// ============================================================================
+// Results
+// ============================================================================
+
+struct Config {
+    uint64_t count = 100000;        // messages per throughput run
+    uint64_t fanout_count = 10000;  // publishes per fan-out run
+    size_t rounds = 10000;          // round trips per RTT run
+    const char* out = nullptr;
+    const char* capture = nullptr;
+    const char* replay = nullptr;
+    double replay_speed = 0;
+};
+
+// Log space for --capture; the file is sparse, so unused space costs nothing
+constexpr uint64_t CAPTURE_BYTES = 1ull << 30;
+
+std::vector<std::string> g_results;
+
+void add_throughput(const char* bench, const char* direction, const char* path,
+                    const char* message, uint64_t count, uint64_t elapsed_ns, bool ok) {
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"bench\": \"%s\", \"direction\": \"%s\", \"path\": \"%s\", \"message\": \"%s\", "
+             "\"count\": %llu, \"elapsed_ns\": %llu, \"ns_per_msg\": %.1f, \"msgs_per_sec\": %.0f, "
+             "\"ok\": %s}",
+             bench, direction, path, message,
+             static_cast<unsigned long long>(count), static_cast<unsigned long long>(elapsed_ns),
+             count ? static_cast<double>(elapsed_ns) / count : 0.0,
+             elapsed_ns ? count * 1e9 / elapsed_ns : 0.0,
+             ok ? "true" : "false");
+    g_results.emplace_back(buf);
+    fprintf(stderr, "  %-10s %-14s %-16s %-14s %10.1f ns/msg%s\n", bench, direction, path, message,
+            count ? static_cast<double>(elapsed_ns) / count : 0.0, ok ? "" : "  (TIMEOUT)");
+}
+
+void add_fanout(const char* message, int32_t subscribers, uint64_t count, uint64_t elapsed_ns, bool ok) {
+    uint64_t deliveries = count * subscribers;
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"bench\": \"fanout\", \"direction\": \"cpp_to_rust\", \"path\": \"ActorRef\", "
+             "\"message\": \"%s\", \"subscribers\": %d, \"count\": %llu, \"elapsed_ns\": %llu, "
+             "\"ns_per_publish\": %.1f, \"deliveries_per_sec\": %.0f, \"ok\": %s}",
+             message, subscribers,
+             static_cast<unsigned long long>(count), static_cast<unsigned long long>(elapsed_ns),
+             count ? static_cast<double>(elapsed_ns) / count : 0.0,
+             elapsed_ns ? deliveries * 1e9 / elapsed_ns : 0.0,
+             ok ? "true" : "false");
+    g_results.emplace_back(buf);
+    fprintf(stderr, "  %-10s %-14s x%-15d %-14s %10.1f ns/publish%s\n", "fanout", "cpp_to_rust",
+            subscribers, message, count ? static_cast<double>(elapsed_ns) / count : 0.0,
+            ok ? "" : "  (TIMEOUT)");
+}
+
+void add_rtt(const char* direction, const char* message, std::vector<uint64_t> samples, size_t rounds) {
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double q) -> unsigned long long {
+        if (samples.empty()) return 0;
+        size_t i = std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()));
+        return samples[i];
+    };
+    double mean = 0;
+    for (uint64_t s : samples) mean += s;
+    if (!samples.empty()) mean /= samples.size();
+
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"bench\": \"rtt\", \"direction\": \"%s\", \"path\": \"ActorRef\", \"message\": \"%s\", "
+             "\"rounds\": %zu, \"min_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+             "\"p999_ns\": %llu, \"max_ns\": %llu, \"mean_ns\": %.1f, \"ok\": %s}",
+             direction, message, samples.size(), pct(0.0), pct(0.50), pct(0.99), pct(0.999),
+             samples.empty() ? 0ull : static_cast<unsigned long long>(samples.back()), mean,
+             samples.size() == rounds ? "true" : "false");
+    g_results.emplace_back(buf);
+    fprintf(stderr, "  %-10s %-14s %-16s %-14s p50 %llu  p99 %llu  p99.9 %llu ns\n", "rtt", direction,
+            "ActorRef", message, pct(0.50), pct(0.99), pct(0.999));
+}
+
+void add_replay(const char* file, double speed, const InteropReplaySummary& r, bool ok) {
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"bench\": \"replay\", \"file\": \"%s\", \"speed\": %.2f, \"sent\": %llu, "
+             "\"skipped\": %llu, \"failed\": %llu, \"elapsed_ns\": %llu, \"ok\": %s}",
+             file, speed, static_cast<unsigned long long>(r.sent), static_cast<unsigned long long>(r.skipped),
+             static_cast<unsigned long long>(r.failed), static_cast<unsigned long long>(r.elapsed_ns),
+             ok ? "true" : "false");
+    g_results.push_back(buf);
+}
+
+void write_json(const Config& cfg) {
+    FILE* out = cfg.out ? fopen(cfg.out, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "cannot open %s\n", cfg.out);
+        return;
+    }
+    fprintf(out, "{\n  \"suite\": \"actors-interop\",\n  \"schema\": 1,\n");
+    fprintf(out, "  \"config\": {\"count\": %llu, \"fanout_count\": %llu, \"rounds\": %zu, "
+                 "\"hardware_concurrency\": %u},\n",
+            static_cast<unsigned long long>(cfg.count), static_cast<unsigned long long>(cfg.fanout_count),
+            cfg.rounds, std::thread::hardware_concurrency());
+    fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < g_results.size(); i++) {
+        fprintf(out, "    %s%s\n", g_results[i].c_str(), i + 1 < g_results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) fclose(out);
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+/// One-way: count messages from the main thread, timed until all arrive
+template <typename Send, typename Received>
+void throughput(const char* bench, const char* direction, const char* path, const char* message,
+                uint64_t count, Send send, Received received, bool conflated = false) {
+    uint64_t before = received();
+    uint64_t start = now_ns();
+    uint64_t end = send() ? arrived(received, before, before + count, conflated) : 0;
+    add_throughput(bench, direction, path, message, count, (end ? end : now_ns()) - start, end != 0);
+}
+
+template <typename M>
+void bench_message(BenchManager& mgr, const Config& cfg, const char* message) {
+    actors::ActorRef rust_sink = mgr.get_ref("bench_rust_sink_0");
+    actors::ActorRef cpp_sink = mgr.get_ref("bench_cpp_sink");
+    auto rust_received = [] { return bench_rust_received(0); };
+    auto cpp_received = [&] { return mgr.sink->received.load(std::memory_order_relaxed); };
+    constexpr bool conflated = interop::conflated<M>::value;  // bridged sends only
+
+    // One-way throughput through ActorRef
+    throughput("throughput", "cpp_to_rust", "ActorRef", message, cfg.count, [&] {
+        for (uint64_t i = 0; i < cfg.count; i++) rust_sink.send(new M(), nullptr);
+        return true;
+    }, rust_received, conflated);
+    throughput("throughput", "rust_to_cpp", "ActorRef", message, cfg.count, [&] {
+        return bench_rust_send("bench_cpp_sink", M::ID, cfg.count, RUST_ACTOR_REF) == 0;
+    }, cpp_received, conflated);
+    throughput("throughput", "cpp_local", "LocalActorRef", message, cfg.count, [&] {
+        for (uint64_t i = 0; i < cfg.count; i++) cpp_sink.send(new M(), nullptr);
+        return true;
+    }, cpp_received);
+
+    // send() vs fast_send() through the FFI interfaces
+    interop::RustActorIF rust_if("bench_rust_sink_0");
+    M m{};
+    throughput("send_mode", "cpp_to_rust", "send", message, cfg.count, [&] {
+        for (uint64_t i = 0; i < cfg.count; i++) rust_if.send(m);
+        return true;
+    }, rust_received, conflated);
+    throughput("send_mode", "cpp_to_rust", "fast_send", message, cfg.count, [&] {
+        for (uint64_t i = 0; i < cfg.count; i++) rust_if.fast_send(m);
+        return true;
+    }, rust_received);
+    throughput("send_mode", "rust_to_cpp", "send", message, cfg.count, [&] {
+        return bench_rust_send("bench_cpp_sink", M::ID, cfg.count, RUST_IF_SEND) == 0;
+    }, cpp_received, conflated);
+    throughput("send_mode", "rust_to_cpp", "fast_send", message, cfg.count, [&] {
+        return bench_rust_send("bench_cpp_sink", M::ID, cfg.count, RUST_IF_FAST_SEND) == 0;
+    }, cpp_received);
+
+    // Direct calls - the handler runs inline, so nothing is queued
+    interop::RustActorIF rust_direct("bench_rust_direct");
+    throughput("send_mode", "cpp_to_rust", "direct", message, cfg.count, [&] {
+        for (uint64_t i = 0; i < cfg.count; i++) rust_direct.send(m);
+        return true;
+    }, [] { return bench_rust_direct_received(); });
+    throughput("send_mode", "rust_to_cpp", "direct", message, cfg.count, [&] {
+        return bench_rust_send("bench_cpp_direct", M::ID, cfg.count, RUST_IF_SEND) == 0;
+    }, [&] { return mgr.direct_sink.received.load(std::memory_order_relaxed); });
+
+    // Ping-pong round trips
+    add_rtt("cpp_rust_cpp", message,
+            mgr.pinger->run<M>(mgr.get_ref("bench_rust_echo"), cfg.rounds), cfg.rounds);
+    add_rtt("cpp_local", message,
+            mgr.pinger->run<M>(mgr.get_ref("bench_cpp_echo"), cfg.rounds), cfg.rounds);
+
+    // Fan-out: every publish goes to each of the first N Rust sinks
+    for (int32_t n : FANOUTS) {
+        std::vector<actors::ActorRef> subs;
+        for (int32_t i = 0; i < n; i++) {
+            subs.push_back(mgr.get_ref("bench_rust_sink_" + std::to_string(i)));
+        }
+        auto received = [n] {
+            uint64_t total = 0;
+            for (int32_t i = 0; i < n; i++) total += bench_rust_received(i);
+            return total;
+        };
+        uint64_t before = received();
+
+        uint64_t start = now_ns();
+        for (uint64_t k = 0; k < cfg.fanout_count; k++) {
+            for (auto& sub : subs) sub.send(new M(), nullptr);
+        }
+        uint64_t end = arrived(received, before, before + n * cfg.fanout_count, conflated);
+        add_fanout(message, n, cfg.fanout_count, (end ? end : now_ns()) - start, end != 0);
+    }
+}
+
+Config parse_args(int argc, char** argv) {
+    Config cfg;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--count")) cfg.count = strtoull(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--fanout-count")) cfg.fanout_count = strtoull(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--rounds")) cfg.rounds = strtoull(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--out")) cfg.out = argv[i + 1];
+        else if (!strcmp(argv[i], "--capture")) cfg.capture = argv[i + 1];
+        else if (!strcmp(argv[i], "--replay")) cfg.replay = argv[i + 1];
+        else if (!strcmp(argv[i], "--replay-speed")) cfg.replay_speed = strtod(argv[i + 1], nullptr);
+    }
+    return cfg;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Config cfg = parse_args(argc, argv);
+
+    BenchManager mgr;
+    cpp_actor_init(&mgr);
+    create_rust_manager();
+    const void* rust_mgr = register_rust_bench_actors(MAX_FANOUT);
+    rust_actor_init(rust_mgr);
+    init_cpp_actor_lookup();
+    mgr.init();
+    rust_manager_init();
+    mgr.build_directory();
+
+    if (cfg.replay) {
+        fprintf(stderr, "=== replaying %s ===\n", cfg.replay);
+        InteropReplaySummary r{};
+        bool ok = interop_replay(cfg.replay, cfg.replay_speed, &r) == 0;
+        if (!ok) fprintf(stderr, "cannot replay %s\n", cfg.replay);
+        add_replay(cfg.replay, cfg.replay_speed, r, ok && r.failed == 0);
+    } else {
+        if (cfg.capture && interop_capture_start(cfg.capture, CAPTURE_BYTES) != 0) {
+            fprintf(stderr, "cannot capture to %s\n", cfg.capture);
+            cfg.capture = nullptr;
+        }
+        fprintf(stderr, "=== actors-interop benchmarks (count %llu, rounds %zu) ===\n",
+                static_cast<unsigned long long>(cfg.count), cfg.rounds);
+#define X(Name, Id) bench_message<msg::Name>(mgr, cfg, #Name);
+        INTEROP_MESSAGE_LIST(X)
+#undef X
+        InteropCaptureSummary c{};
+        if (cfg.capture && interop_capture_stop(&c) == 0) {
+            fprintf(stderr, "captured %llu records (%llu dropped, %llu bytes) to %s\n",
+                    static_cast<unsigned long long>(c.records), static_cast<unsigned long long>(c.dropped),
+                    static_cast<unsigned long long>(c.bytes), cfg.capture);
+        }
+    }
+
+    write_json(cfg);
+
+    // Results are written - what is still queued can go
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DISCARD, 0, 0};
+    interop_shutdown(&shutdown);
+    return 0;
+}
@@ -0,0 +1,180 @@
+//! Rust side of the cross-language benchmark suite (see bench/main.cpp)
+//!
+//! - BenchSink counts every message it receives (one counter per sink)
+//! - BenchEcho sends every message straight back to the C++ pinger
+//! - BenchDirectSink counts messages delivered by direct call
+//! - bench_rust_send() drives Rust -> C++ sends from the calling thread
+//!
+//! C++ registers them with register_rust_actors(), by the factory IDs of
+//! "BenchSink", "BenchEcho" and "BenchDirectSink" (see FACTORIES).
+//!
+//! The handlers cover every type in interop_messages.h via
+//! interop_message_list!, so new messages are benchmarked automatically.
+
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+use actors::{handle_messages, ActorContext, ActorRef, Message};
+use crate::cpp_actor_if::{CppActorIF, InteropMessage};
+use crate::interop_messages::*;
+use crate::rust_actor_bridge::{DirectActor, MessageView};
+use crate::rust_manager_ffi::{get_actor_ref, Factory};
+
+/// Maximum number of sinks (bench_rust_sink_0 .. bench_rust_sink_{N-1})
+pub const MAX_SINKS: usize = 16;
+
+/// Name of the C++ actor that BenchEcho replies to
+const CPP_PINGER: &str = "bench_cpp_pinger";
+
+static RECEIVED: [AtomicU64; MAX_SINKS] = [const { AtomicU64::new(0) }; MAX_SINKS];
+static DIRECT_RECEIVED: AtomicU64 = AtomicU64::new(0);
+
+/// Counter of the next sink built - sinks count in the order they are registered
+static NEXT_SINK: AtomicUsize = AtomicUsize::new(0);
+
+/// Actor kinds for register_rust_actors() (added to the factory table)
+pub const FACTORIES: [(&str, Factory); 3] = [
+    ("BenchSink", Factory::Actor(|_| Box::new(BenchSink::new()))),
+    ("BenchEcho", Factory::Actor(|_| Box::new(BenchEcho::new()))),
+    ("BenchDirectSink", Factory::Direct(|| Box::new(BenchDirectSink))),
+];
+
+/// Counts every message it receives
+pub struct BenchSink {
+    index: usize,
+}
+
+impl BenchSink {
+    /// Takes the next counter; past MAX_SINKS sinks share the last one
+    pub fn new() -> Self {
+        BenchSink { index: NEXT_SINK.fetch_add(1, Ordering::Relaxed).min(MAX_SINKS - 1) }
+    }
+
+    fn on_msg<M>(&mut self, _msg: &M, _ctx: &mut ActorContext) {
+        RECEIVED[self.index].fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Sends every message back to the C++ pinger
+pub struct BenchEcho {
+    pinger: Option<ActorRef>,
+}
+
+impl BenchEcho {
+    pub fn new() -> Self {
+        BenchEcho { pinger: None }
+    }
+
+    fn on_msg<M: Message + Clone + 'static>(&mut self, msg: &M, _ctx: &mut ActorContext) {
+        if self.pinger.is_none() {
+            self.pinger = get_actor_ref(CPP_PINGER, "bench_rust_echo");
+        }
+        if let Some(pinger) = &self.pinger {
+            pinger.send(Box::new(msg.clone()), None);
+        }
+    }
+}
+
+/// Counts every message sent to it by direct call (runs on the sender's thread)
+pub struct BenchDirectSink;
+
+impl DirectActor for BenchDirectSink {
+    fn on_direct(&mut self, _msg: &MessageView<'_>, _sender_handle: i32) {
+        DIRECT_RECEIVED.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+macro_rules! bench_handlers {
+    ($($msg:ident),* $(,)?) => {
+        handle_messages!(BenchSink, $($msg => on_msg),*);
+        handle_messages!(BenchEcho, $($msg => on_msg),*);
+    };
+}
+crate::interop_message_list!(bench_handlers);
+
+// ============================================================================
+// Driver - called from the C++ harness
+// ============================================================================
+
+/// A message with every field zeroed
+fn zeroed<M: InteropMessage>() -> M
+where
+    M::CStruct: Default,
+{
+    M::from_c_struct(&M::CStruct::default())
+}
+
+/// Send `count` copies of `msg` to a C++ actor from the calling thread
+/// mode: 0 = ActorRef::send, 1 = CppActorIF::send, 2 = CppActorIF::fast_send
+fn send_n<M: InteropMessage + Message + Clone + 'static>(target: &str, msg: &M, count: u64, mode: c_int) -> c_int {
+    match mode {
+        0 => {
+            let actor_ref = match get_actor_ref(target, "") {
+                Some(r) => r,
+                None => return -1,
+            };
+            for _ in 0..count {
+                actor_ref.send(Box::new(msg.clone()), None);
+            }
+        }
+        1 | 2 => {
+            let cpp_actor = CppActorIF::new(target, None);
+            if !cpp_actor.exists() {
+                return -1;
+            }
+            for _ in 0..count {
+                if mode == 1 {
+                    cpp_actor.send(msg);
+                } else {
+                    cpp_actor.fast_send(msg);
+                }
+            }
+        }
+        _ => return -1,
+    }
+    0
+}
+
+macro_rules! bench_send_typed {
+    ($($msg:ident),* $(,)?) => {
+        fn send_typed(target: &str, msg_type: i32, count: u64, mode: c_int) -> c_int {
+            $(
+                if msg_type == <$msg>::ID {
+                    return send_n(target, &zeroed::<$msg>(), count, mode);
+                }
+            )*
+            -2  // Unknown message type
+        }
+    };
+}
+crate::interop_message_list!(bench_send_typed);
+
+/// Send `count` zeroed messages of `msg_type` to a C++ actor
+/// Returns 0 on success, -1 if the actor is not found or mode is invalid,
+/// -2 if unknown message type
+#[no_mangle]
+pub extern "C" fn bench_rust_send(target: *const c_char, msg_type: c_int, count: u64, mode: c_int) -> c_int {
+    if target.is_null() {
+        return -1;
+    }
+    match unsafe { CStr::from_ptr(target) }.to_str() {
+        Ok(t) => send_typed(t, msg_type, count, mode),
+        Err(_) => -1,
+    }
+}
+
+/// Messages received so far by sink `index`
+#[no_mangle]
+pub extern "C" fn bench_rust_received(index: c_int) -> u64 {
+    match RECEIVED.get(index as usize) {
+        Some(c) => c.load(Ordering::Relaxed),
+        None => 0,
+    }
+}
+
+/// Messages received so far by bench_rust_direct
+#[no_mangle]
+pub extern "C" fn bench_rust_direct_received() -> u64 {
+    DIRECT_RECEIVED.load(Ordering::Relaxed)
+}
@@ -2,73 +2,131 @@
  * RustActorRef::send() implementation
  *
  * This file implements the send() method for actors::RustActorRef.
- * It dispatches messages to Rust actors via FFI based on message ID.
+ * It dispatches messages to Rust actors via FFI through the generated
+ * table in RustActorIF.hpp, indexed by message ID.
+ *
+ * RustActorRef itself is declared in actors-cpp, so resolved handles are
+ * cached here per thread, keyed by the address of the name's characters.
+ * Each thread resolves a name through the bridge once; after that a send
+ * finds its handles with a pointer compare and a memcmp - no hashing, no
+ * FFI name lookup - and goes straight to rust_actor_send_h(). Once the
+ * actor directory is built, Rust handles come from it instead of
+ * rust_actor_resolve().
  */
 
+#include <cstring>
+#include <string>
 #include "actors/ActorRef.hpp"
 #include "InteropMessages.hpp"
+#include "InteropManager.hpp"
+#include "ActorDirectory.hpp"
+#include "CppActorBridge.hpp"
+#include "RustActorIF.hpp"
+#include "InteropStats.hpp"
 
-// Forward declare the Rust bridge function
-extern "C" {
-    int32_t rust_actor_send(
-        const char* actor_name,
-        const char* sender_name,
-        int32_t msg_type,
-        const void* msg_data
-    );
-}
+namespace {
 
-namespace actors {
+using Resolver = int32_t (*)(const char*);
 
-void RustActorRef::send(const Message* m, [[maybe_unused]] Actor* sender) {
-    const char* sender_name_cstr = sender_name_.empty() ? nullptr : sender_name_.c_str();
+/**
+ * HandleCache - a thread's resolved handles, direct-mapped by the address
+ * of the name's characters (a ref's std::string, or an Actor's name array).
+ *
+ * A hit is a pointer compare plus a memcmp against the name copied at
+ * resolve time, so storage freed and reused for another name misses. An
+ * entry from an earlier handle epoch (before a bridge shutdown) misses
+ * too. Only successful resolutions are cached, so an actor registered
+ * later is picked up on the next send.
+ */
+class HandleCache {
+    static constexpr size_t kSlots = 64;
 
-    // Dispatch by message ID
-    switch (m->get_message_id()) {
-        case 1000: {  // Ping
-            auto c_msg = static_cast<const msg::Ping*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1000, &c_msg);
-            break;
-        }
-        case 1001: {  // Pong
-            auto c_msg = static_cast<const msg::Pong*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1001, &c_msg);
-            break;
-        }
-        case 1002: {  // DataRequest
-            auto c_msg = static_cast<const msg::DataRequest*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1002, &c_msg);
-            break;
-        }
-        case 1003: {  // DataResponse
-            auto c_msg = static_cast<const msg::DataResponse*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1003, &c_msg);
-            break;
-        }
-        case 1010: {  // Subscribe
-            auto c_msg = static_cast<const msg::Subscribe*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1010, &c_msg);
-            break;
-        }
-        case 1011: {  // Unsubscribe
-            auto c_msg = static_cast<const msg::Unsubscribe*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1011, &c_msg);
-            break;
-        }
-        case 1012: {  // MarketUpdate
-            auto c_msg = static_cast<const msg::MarketUpdate*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1012, &c_msg);
-            break;
+    struct Entry {
+        const char* key = nullptr;
+        uint32_t epoch = 0;
+        int32_t handle = -1;
+        std::string name;
+    };
+
+    Entry slots_[kSlots];
+
+public:
+    int32_t get(const char* name, size_t len, Resolver resolve) {
+        auto p = reinterpret_cast<uintptr_t>(name);
+        Entry& e = slots_[((p >> 3) ^ (p >> 9)) & (kSlots - 1)];
+        uint32_t epoch = interop::handle_epoch();
+        if (e.key == name && e.epoch == epoch && e.name.size() == len &&
+            std::memcmp(e.name.data(), name, len) == 0) {
+            return e.handle;
         }
-        case 1013: {  // MarketDepth
-            auto c_msg = static_cast<const msg::MarketDepth*>(m)->to_c_struct();
-            rust_actor_send(target_name_.c_str(), sender_name_cstr, 1013, &c_msg);
-            break;
+        int32_t handle = resolve(name);
+        if (handle >= 0) {
+            e.key = name;
+            e.epoch = epoch;
+            e.handle = handle;
+            e.name.assign(name, len);
         }
-        default:
-            // Unknown message type - silently ignore
-            break;
+        return handle;
     }
+};
+
+int32_t cpp_handle(const std::string& name) {
+    thread_local HandleCache cache;
+    return cache.get(name.c_str(), name.size(), cpp_actor_resolve);
+}
+
+// Keyed by the actor's name array so the hot path never builds a std::string
+int32_t cpp_handle(const actors::Actor* actor) {
+    thread_local HandleCache cache;
+    return cache.get(actor->name, std::strlen(actor->name), cpp_actor_resolve);
+}
+
+// A built directory answers with one probe; before that, ask the bridge
+int32_t find_rust(const char* name) {
+    InteropActorLocation loc;
+    if (interop_directory_find(name, &loc) == 0) {
+        return loc.runtime == INTEROP_RUNTIME_RUST ? loc.handle : -1;
+    }
+    return interop::directory_built() ? -1 : rust_actor_resolve(name);
+}
+
+// Result of this thread's last send, for interop::last_send_status()
+thread_local int32_t g_last_send_status = 0;
+
+} // anonymous namespace
+
+namespace interop {
+
+int32_t rust_handle(const std::string& name) {
+    thread_local HandleCache cache;
+    return cache.get(name.c_str(), name.size(), find_rust);
+}
+
+int32_t last_send_status() {
+    return g_last_send_status;
+}
+
+} // namespace interop
+
+namespace actors {
+
+void RustActorRef::send(const Message* m, Actor* sender) {
+    // Reply routing uses the explicit sender name, else the sending actor
+    const char* sender_name_cstr = nullptr;
+    int32_t sender_handle = -1;
+    if (!sender_name_.empty()) {
+        sender_name_cstr = sender_name_.c_str();
+        sender_handle = cpp_handle(sender_name_);
+    } else if (sender) {
+        sender_name_cstr = sender->name;
+        sender_handle = cpp_handle(sender);
+    }
+    int32_t handle = interop::rust_handle(target_name_);
+
+    // Dispatch by message ID through the generated table. Plain-data
+    // messages are passed to Rust in place; unknown types are ignored.
+    interop::RustSendTarget t{target_name_.c_str(), handle, sender_name_cstr, sender_handle};
+    g_last_send_status = interop::stats::status(INTEROP_PATH_RUST_ACTOR_REF_SEND, interop::rust_send(t, m));
 
     // Delete the message (caller expects us to take ownership)
     delete m;
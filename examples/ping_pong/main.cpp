@@ -13,10 +13,14 @@
  * 1. Create InteropManager (extended Manager with Rust lookup)
  * 2. Initialize C++ actor bridge with cpp_actor_init(&mgr)
  * 3. Create Rust Manager with create_rust_manager()
- * 4. Register rust_pong actor with register_rust_pong_actor()
+ * 4. Register rust_pong next to cpp_ping (sharing CPU 0's L2) with
+ *    manage_rust_near()
  * 5. Initialize Rust actor bridge with rust_actor_init(rust_mgr_ptr)
  * 6. Start actors with mgr.init()
  * 7. Start Rust actors with rust_manager_init()
+ * 8. Build the actor directory with mgr.build_directory()
+ * 9. Once cpp_ping terminates the C++ Manager, interop_shutdown() drains
+ *    and stops rust_pong and closes both bridges
  */
 
 #include <iostream>
@@ -26,17 +30,16 @@
 #include "InteropMessages.hpp"
 #include "InteropManager.hpp"  // Extended Manager for cross-language lookup
 #include "CppActorBridge.hpp"
+#include "InteropShutdown.hpp"
+#include "ThreadPlacement.hpp"
 
 using namespace std;
 
 // Forward declare Rust Manager FFI functions
 extern "C" {
     void create_rust_manager();
-    void* register_rust_pong_actor();
     void rust_manager_init();
-    void rust_manager_end();
     void rust_actor_init(const void* mgr);
-    void rust_actor_shutdown();
 }
 
 /**
@@ -63,6 +66,9 @@ public:
     }
 
     void on_start(const actors::msg::Start*) noexcept {
+        // Stay on CPU 0; rust_pong is pinned to a core sharing its L2
+        interop::pin_current_thread({0});
+
         // Get an ActorRef by name - location transparent!
         // Works the same whether target is C++ or Rust.
         pong_ref_ = static_cast<interop::InteropManager*>(manager_)->get_ref("rust_pong");
@@ -110,8 +116,9 @@ int main() {
     // 3. Create Rust Manager
     create_rust_manager();
 
-    // 4. Register rust_pong actor
-    void* rust_mgr = register_rust_pong_actor();
+    // 4. Register rust_pong actor, co-located with cpp_ping on CPU 0
+    const void* rust_mgr = mgr.manage_rust_near(
+        "rust_pong", rust_actor_factory("RustPongActor"), 0);
 
     // 5. Initialize Rust actor bridge
     rust_actor_init(rust_mgr);
@@ -125,15 +132,15 @@ int main() {
     // 7. Start Rust actors
     rust_manager_init();
 
-    // Wait for completion
-    mgr.end();
+    // 8. Build the actor directory - later lookups are one local probe
+    mgr.build_directory();
 
-    cout << endl;
-    cout << "[Main] Shutting down..." << endl;
+    // 9. Wait for cpp_ping to finish, then stop everything
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DRAIN, 100, INTEROP_RUNTIME_CPP};
+    interop_shutdown(&shutdown);
 
-    rust_manager_end();
-    rust_actor_shutdown();
-    cpp_actor_shutdown();
+    cout << endl;
+    cout << "[Main] Shut down" << endl;
 
     return 0;
 }
@@ -20,19 +20,15 @@
 #include "InteropMessages.hpp"
 #include "InteropManager.hpp"  // Extended Manager for cross-language lookup
 #include "CppActorBridge.hpp"
-#include <thread>
-#include <chrono>
+#include "InteropShutdown.hpp"
 
 using namespace std;
 
 // Forward declare Rust Manager FFI functions
 extern "C" {
     void create_rust_manager();
-    void* register_rust_publisher();
     void rust_manager_init();
-    void rust_manager_end();
     void rust_actor_init(const void* mgr);
-    void rust_actor_shutdown();
     void init_cpp_actor_lookup();  // Register C++ actor lookup for Rust
 }
 
@@ -47,6 +43,7 @@ class MarketSubscriber : public actors::Actor {
     actors::Actor* manager_;
     int update_count_ = 0;
     bool publisher_resolved_ = false;
+    interop_symbol aapl_ = INTEROP_NO_SYMBOL;
 
 public:
     MarketSubscriber(actors::Actor* mgr)
@@ -65,23 +62,17 @@ public:
 
         cout << "[C++ Subscriber] Starting, subscribing to AAPL via ActorRef..." << endl;
 
-        auto* sub = new msg::Subscribe();
-        std::fill(sub->topic.begin(), sub->topic.end(), '\0');
-        const char* sym = "AAPL";
-        std::copy(sym, sym + 4, sub->topic.begin());
-
-        publisher_ref_.send(sub, this);
+        aapl_ = interop::intern("AAPL");
+        publisher_ref_.send(new msg::Subscribe(aapl_), this);
     }
 
     void on_update(const msg::MarketUpdate* m) noexcept {
         std::cerr << "[C++ Subscriber] on_update called" << std::endl;
+        if (m->symbol != aapl_) return;  // integer compare - no string work
         update_count_++;
 
-        string symbol(m->symbol.begin(),
-            std::find(m->symbol.begin(), m->symbol.end(), '\0'));
-
         cout << "[C++ Subscriber] Update #" << update_count_
-             << ": " << symbol
+             << ": " << m->symbol_name()
              << " @ $" << m->price
              << " vol=" << m->volume << endl;
 
@@ -117,8 +108,8 @@ int main() {
     // 3. Create Rust Manager
     create_rust_manager();
 
-    // 4. Register rust_publisher actor
-    void* rust_mgr = register_rust_publisher();
+    // 4. Register rust_publisher actor by factory ID
+    const void* rust_mgr = mgr.manage_rust("rust_publisher", rust_actor_factory("RustPublisher"));
 
     // 5. Initialize Rust actor bridge
     rust_actor_init(rust_mgr);
@@ -135,18 +126,15 @@ int main() {
     // 7. Start Rust actors
     rust_manager_init();
 
-    // Give time for messages to be processed
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    // 8. Build the actor directory - later lookups are one local probe
+    mgr.build_directory();
 
-    // Wait for completion
-    mgr.end();
+    // 9. Wait for the subscriber to get its updates, then stop everything
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DRAIN, 100, INTEROP_RUNTIME_CPP};
+    interop_shutdown(&shutdown);
 
     cout << endl;
-    cout << "[Main] Shutting down..." << endl;
-
-    rust_manager_end();
-    rust_actor_shutdown();
-    cpp_actor_shutdown();
+    cout << "[Main] Shut down" << endl;
 
     return 0;
 }
@@ -2,6 +2,8 @@
 //!
 //! Receives Subscribe from subscribers, sends MarketUpdates back.
 //! Uses ActorRef for location transparency - doesn't know if subscribers are C++ or Rust.
+//! Per-topic subscriber lists live in a TopicPublisher, which batches every
+//! C++ delivery of a tick into one FFI call.
 //!
 //! Uses the standard Actor trait with handle_messages! macro.
 
@@ -11,12 +13,13 @@ use actors::{handle_messages, ActorContext, ActorRef, ManagerHandle};
 use actors::messages::Start;
 use crate::interop_messages::{Subscribe, MarketUpdate};
 use crate::rust_manager_ffi::get_actor_ref;
+use crate::topic_publisher::TopicPublisher;
 
 pub struct RustPublisher {
     // ActorRef to subscriber - location transparent!
     cpp_subscriber: Option<ActorRef>,
-    // Track subscribed topics
-    topics: Vec<String>,
+    // Subscribers per topic
+    feed: TopicPublisher<MarketUpdate>,
     // Count of updates sent (for demo purposes)
     update_count: i32,
     #[allow(dead_code)]
@@ -28,7 +31,7 @@ impl RustPublisher {
         RustPublisher {
             // Will be looked up on first use
             cpp_subscriber: None,
-            topics: Vec::new(),
+            feed: TopicPublisher::new("rust_publisher"),
             update_count: 0,
             manager_handle,
         }
@@ -48,27 +51,24 @@ impl RustPublisher {
     }
 
     fn on_subscribe(&mut self, msg: &Subscribe, _ctx: &mut ActorContext) {
-        let topic = std::str::from_utf8(&msg.topic)
-            .unwrap_or("")
-            .trim_end_matches('\0')
-            .to_string();
+        let topic = msg.topic_name();
 
         println!("[Rust Publisher] Subscriber subscribing to '{}'", topic);
 
-        if !self.topics.contains(&topic) {
-            self.topics.push(topic.clone());
-        }
-
-        // Get subscriber ActorRef and send updates
-        let subscriber = self.get_subscriber();
+        // Get subscriber ActorRef and add it to the topic
+        let subscriber = match self.get_subscriber() {
+            Some(s) => s,
+            None => return,
+        };
+        self.feed.subscribe(msg.topic, "cpp_subscriber", &subscriber);
 
-        // Send 3 updates via ActorRef - location transparent!
+        // Publish 3 updates to the topic - location transparent!
         for i in 0..3 {
             self.update_count += 1;
             let price = 150.0 + (i as f64 * 0.25);
 
-            let mut update = MarketUpdate {
-                symbol: [0u8; 8],
+            let update = MarketUpdate {
+                symbol: msg.topic,
                 price,
                 timestamp: SystemTime::now()
                     .duration_since(UNIX_EPOCH)
@@ -77,15 +77,13 @@ impl RustPublisher {
                 volume: (i + 1) * 100,
             };
 
-            let bytes = topic.as_bytes();
-            update.symbol[..bytes.len().min(7)].copy_from_slice(&bytes[..bytes.len().min(7)]);
-
             println!("[Rust Publisher] Sending update: {} @ ${:.2}", topic, price);
 
-            if let Some(ref sub) = subscriber {
-                sub.send(Box::new(update), None);
-            }
+            self.feed.publish(msg.topic, &update);
         }
+
+        // C++ subscribers get all 3 updates in one FFI call
+        self.feed.flush();
     }
 }
 
@@ -14,13 +14,13 @@
  */
 
 #include <iostream>
-#include <thread>
-#include <chrono>
 #include "actors/Actor.hpp"
 #include "actors/act/Manager.hpp"
 #include "actors/msg/Start.hpp"
 #include "InteropMessages.hpp"
 #include "CppActorBridge.hpp"
+#include "InteropShutdown.hpp"
+#include "RustActorRegistry.hpp"
 
 using namespace std;
 
@@ -28,14 +28,11 @@ using namespace std;
 extern "C" {
     // Rust Manager management
     void create_rust_manager();
-    void* register_rust_ping_actor();  // Returns Manager pointer
     void* get_rust_manager();
     void rust_manager_init();
-    void rust_manager_end();
 
     // Rust actor bridge (from generated code)
     void rust_actor_init(const void* mgr);
-    void rust_actor_shutdown();
     void init_cpp_actor_lookup();  // Register C++ actor lookup for Rust
 }
 
@@ -79,9 +76,13 @@ int main() {
     // 2. Initialize C++ actor bridge with Manager pointer
     cpp_actor_init(&cpp_mgr);
 
-    // 3. Create Rust Manager and register RustPingActor
+    // 3. Create Rust Manager and register RustPingActor (one spec per actor,
+    //    any number per call)
     create_rust_manager();
-    void* rust_mgr = register_rust_ping_actor();
+    const InteropActorSpec specs[] = {
+        {"rust_ping", rust_actor_factory("RustPingActor"), nullptr},
+    };
+    const void* rust_mgr = register_rust_actors(specs, 1, nullptr);
 
     // 4. Initialize Rust actor bridge with Rust Manager pointer
     rust_actor_init(rust_mgr);
@@ -94,17 +95,12 @@ int main() {
     cpp_mgr.init();       // C++ actors receive Start
     rust_manager_init();  // Rust actors receive Start
 
-    // Wait for ping-pong to complete (3 rounds)
-    this_thread::sleep_for(chrono::milliseconds(500));
-
-    // Shutdown
-    rust_manager_end();
-    cpp_mgr.end();
+    // 7. Wait for rust_ping to finish its 3 rounds (it terminates the Rust
+    //    Manager), then drain and stop cpp_pong and close both bridges
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DRAIN, 100, INTEROP_RUNTIME_RUST};
+    interop_shutdown(&shutdown);
 
     cout << endl << "[Main] Done!" << endl;
 
-    rust_actor_shutdown();
-    cpp_actor_shutdown();
-
     return 0;
 }
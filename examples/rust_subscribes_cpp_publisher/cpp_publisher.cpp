@@ -3,28 +3,25 @@
  *
  * This C++ actor publishes market data to subscribers (C++ or Rust).
  * It demonstrates:
- * - Location transparency - uses ActorRef for all subscribers
+ * - Location transparency - subscribers are whatever get_reply_to() returns
  * - Receiving Subscribe messages from any actor
- * - Storing subscriber ActorRefs for later updates
+ * - Interned symbols: Subscribe and MarketUpdate carry interop_symbol IDs,
+ *   so topics are compared and indexed as integers
+ * - interop::TopicPublisher: each topic keeps its own subscriber list, and
+ *   a tick reaches all Rust subscribers in one FFI call (flush)
  * - The pub/sub pattern across language boundaries
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <cstring>
 #include <ctime>
 #include <cstdlib>
 #include "actors/Actor.hpp"
-#include "actors/ActorRef.hpp"
 #include "InteropMessages.hpp"
-
-/// Subscriber info - stores ActorRef and subscribed topics
-struct SubscriberInfo {
-    actors::ActorRef ref;
-    std::vector<std::string> topics;
-};
+#include "TopicPublisher.hpp"
 
 class PriceFeed : public actors::Actor {
 public:
@@ -33,115 +30,76 @@ public:
         MESSAGE_HANDLER(msg::Subscribe, on_subscribe);
         MESSAGE_HANDLER(msg::Unsubscribe, on_unsubscribe);
 
-        // Initialize prices
-        prices_["AAPL"] = 150.0;
-        prices_["GOOG"] = 2800.0;
-        prices_["MSFT"] = 380.0;
-        prices_["AMZN"] = 3400.0;
+        // Initialize prices - each symbol is interned to a shared ID
+        set_price("AAPL", 150.0);
+        set_price("GOOG", 2800.0);
+        set_price("MSFT", 380.0);
+        set_price("AMZN", 3400.0);
 
         std::cout << "[C++ Publisher] Created PriceFeed" << std::endl;
     }
 
     /// Publish updates to all subscribers (call periodically)
     void publish_all() {
-        // Simulate price changes
-        for (auto& [symbol, price] : prices_) {
+        // Simulate price changes; one publish per symbol, whatever the
+        // number of subscribers
+        for (interop::TopicId id : symbols_) {
             double change = (static_cast<double>(rand()) / RAND_MAX - 0.5) * 0.01;
-            price *= (1.0 + change);
+            prices_[id] *= (1.0 + change);
+            feed_.publish(id, make_update(id));
         }
 
-        // Send to all subscribers
-        for (const auto& [sub_name, sub_info] : subscribers_) {
-            for (const auto& topic : sub_info.topics) {
-                auto it = prices_.find(topic);
-                if (it != prices_.end()) {
-                    send_update(sub_info, topic, it->second);
-                }
-            }
-        }
+        // Rust subscribers get the whole tick in one FFI call
+        feed_.flush();
     }
 
 private:
-    std::unordered_map<std::string, SubscriberInfo> subscribers_;
-    std::unordered_map<std::string, double> prices_;
+    interop::TopicPublisher<msg::MarketUpdate> feed_{this};
+    std::vector<interop::TopicId> symbols_;  // symbols with a price
+    std::vector<double> prices_;             // indexed by TopicId
+
+    void set_price(const std::string& symbol, double price) {
+        interop::TopicId id = interop::intern(symbol);
+        if (id >= prices_.size()) prices_.resize(id + 1);
+        if (prices_[id] == 0.0) symbols_.push_back(id);
+        prices_[id] = price;
+    }
 
     void on_subscribe(const msg::Subscribe* msg) noexcept {
-        // Extract topic from fixed-size array
-        std::string topic(msg->topic.data(),
-            std::find(msg->topic.begin(), msg->topic.end(), '\0'));
-
-        // Get sender from message metadata
+        // Get sender from message metadata (a Rust actor's proxy or a C++ actor)
         auto* sender = get_reply_to();
         if (!sender) {
             std::cerr << "[C++ Publisher] Subscribe with no sender!" << std::endl;
             return;
         }
 
-        std::string sender_name = sender->get_name();
-
-        std::cout << "[C++ Publisher] " << sender_name
-                  << " subscribing to " << topic << std::endl;
-
-        // Get or create subscriber entry with ActorRef
-        auto it = subscribers_.find(sender_name);
-        if (it == subscribers_.end()) {
-            SubscriberInfo info;
-            info.ref = actors::ActorRef(sender);  // Store ActorRef
-            subscribers_[sender_name] = std::move(info);
-        }
-        auto& subscriber = subscribers_[sender_name];
+        std::cout << "[C++ Publisher] " << sender->get_name()
+                  << " subscribing to " << msg->topic_name() << std::endl;
 
-        // Add topic if not already subscribed
-        if (std::find(subscriber.topics.begin(), subscriber.topics.end(), topic)
-                == subscriber.topics.end()) {
-            subscriber.topics.push_back(topic);
-        }
+        feed_.subscribe(msg->topic, sender);
 
-        // Send initial price update
-        auto price_it = prices_.find(topic);
-        if (price_it != prices_.end()) {
-            send_update(subscriber, topic, price_it->second);
+        // Send initial price update to the new subscriber only
+        if (msg->topic < prices_.size() && prices_[msg->topic] != 0.0) {
+            sender->send(new msg::MarketUpdate(make_update(msg->topic)), this);
         }
     }
 
     void on_unsubscribe(const msg::Unsubscribe* msg) noexcept {
-        std::string topic(msg->topic.data(),
-            std::find(msg->topic.begin(), msg->topic.end(), '\0'));
-
         auto* sender = get_reply_to();
         if (!sender) return;
 
-        std::string sender_name = sender->get_name();
-
-        std::cout << "[C++ Publisher] " << sender_name
-                  << " unsubscribing from " << topic << std::endl;
-
-        auto it = subscribers_.find(sender_name);
-        if (it != subscribers_.end()) {
-            auto& topics = it->second.topics;
-            topics.erase(std::remove(topics.begin(), topics.end(), topic), topics.end());
+        std::cout << "[C++ Publisher] " << sender->get_name()
+                  << " unsubscribing from " << msg->topic_name() << std::endl;
 
-            if (topics.empty()) {
-                subscribers_.erase(it);
-            }
-        }
+        feed_.unsubscribe(msg->topic, sender);
     }
 
-    void send_update(const SubscriberInfo& subscriber,
-                     const std::string& symbol, double price) {
-        auto* update = new msg::MarketUpdate();
-
-        // Copy symbol to fixed-size array
-        std::fill(update->symbol.begin(), update->symbol.end(), '\0');
-        std::copy(symbol.begin(),
-                  symbol.begin() + std::min(symbol.size(), update->symbol.size() - 1),
-                  update->symbol.begin());
-
-        update->price = price;
-        update->timestamp = static_cast<int64_t>(std::time(nullptr)) * 1000;
-        update->volume = rand() % 10000;
-
-        // Location-transparent send - works for C++ or Rust subscribers
-        subscriber.ref.send(update, this);
+    msg::MarketUpdate make_update(interop::TopicId id) const {
+        msg::MarketUpdate update;
+        update.symbol = id;
+        update.price = prices_[id];
+        update.timestamp = static_cast<int64_t>(std::time(nullptr)) * 1000;
+        update.volume = rand() % 10000;
+        return update;
     }
 };
@@ -8,7 +8,10 @@
  *
  * Flow:
  * - Rust RustSubscriber sends Subscribe to C++ CppPriceFeed on Start
- * - C++ stores subscriber as ActorRef and sends MarketUpdates
+ * - C++ adds the sender to its TopicPublisher and publishes MarketUpdates;
+ *   each round reaches every Rust subscriber in one FFI call
+ * - Rust subscribers also get a MarketDepth snapshot by ownership transfer:
+ *   C++ writes it into a Rust-allocated buffer that is delivered as-is
  * - Rust receives updates and prints them
  *
  * Startup sequence:
@@ -19,13 +22,15 @@
  * 5. Initialize Rust actor bridge with rust_actor_init(rust_mgr_ptr)
  * 6. Start C++ actors with mgr.init()
  * 7. Start Rust actors with rust_manager_init()
+ * 8. Build the actor directory with mgr.build_directory()
+ * 9. Publish, then interop_shutdown() lets the Rust subscriber drain its
+ *    updates and stops both runtimes
  */
 
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <cstring>
 #include <ctime>
 #include <cstdlib>
@@ -37,6 +42,9 @@
 #include "InteropMessages.hpp"
 #include "InteropManager.hpp"
 #include "CppActorBridge.hpp"
+#include "InteropShutdown.hpp"
+#include "TopicPublisher.hpp"
+#include "RustActorIF.hpp"
 
 using namespace std;
 
@@ -44,30 +52,22 @@ using namespace std;
 extern "C" {
     // Rust Manager management
     void create_rust_manager();
-    void* register_rust_subscriber();  // Returns Manager pointer
     void* get_rust_manager();
     void rust_manager_init();
-    void rust_manager_end();
 
     // Rust actor bridge (from generated code)
     void rust_actor_init(const void* mgr);
-    void rust_actor_shutdown();
     void init_cpp_actor_lookup();  // Register C++ actor lookup for Rust
 }
 
-// Subscriber info - now uses ActorRef for location transparency
-struct SubscriberInfo {
-    string name;
-    vector<string> topics;
-    actors::ActorRef ref;  // ActorRef works for C++ or Rust actors!
-};
-
 // C++ Price Feed Publisher
 class CppPriceFeed : public actors::Actor {
-    unordered_map<string, SubscriberInfo> subscribers_;
-    unordered_map<string, double> prices_;
+    // Topic-indexed fan-out: Rust subscribers get each round in one FFI call
+    interop::TopicPublisher<msg::MarketUpdate> feed_{this};
+    vector<interop::TopicId> symbols_;  // symbols with a price
+    vector<double> prices_;             // indexed by TopicId
     int update_count_ = 0;
-    interop::InteropManager* manager_;  // Need InteropManager for get_ref()
+    interop::InteropManager* manager_;
 
 public:
     CppPriceFeed(interop::InteropManager* mgr) : manager_(mgr) {
@@ -75,31 +75,29 @@ public:
         MESSAGE_HANDLER(msg::Subscribe, on_subscribe);
         MESSAGE_HANDLER(msg::Unsubscribe, on_unsubscribe);
 
-        // Initialize prices
-        prices_["AAPL"] = 150.0;
-        prices_["GOOG"] = 2800.0;
-        prices_["MSFT"] = 380.0;
+        // Intern the symbols up front - Subscribe and MarketUpdate carry
+        // the same IDs, so prices are indexed by them directly
+        set_price("AAPL", 150.0);
+        set_price("GOOG", 2800.0);
+        set_price("MSFT", 380.0);
 
         srand(time(nullptr));
         cout << "[C++ Publisher] Created PriceFeed" << endl;
     }
 
     void publish_updates() {
-        // Simulate price changes
-        for (auto& [symbol, price] : prices_) {
+        // Simulate price changes and publish each symbol once
+        for (interop::TopicId id : symbols_) {
             double change = (static_cast<double>(rand()) / RAND_MAX - 0.5) * 2.0;
-            price += change;
-        }
+            prices_[id] += change;
 
-        // Send to all subscribers
-        for (auto& [sub_name, sub_info] : subscribers_) {
-            for (const auto& topic : sub_info.topics) {
-                auto it = prices_.find(topic);
-                if (it != prices_.end()) {
-                    send_update(sub_info, topic, it->second);
-                }
+            if (feed_.subscriber_count(id) > 0) {
+                cout << "[C++ Publisher] Sending " << interop::symbol_name(id) << " @ $"
+                     << fixed << setprecision(2) << prices_[id] << endl;
+                feed_.publish(id, make_update(id));
             }
         }
+        feed_.flush();
 
         update_count_++;
         if (update_count_ >= 3) {
@@ -109,67 +107,92 @@ public:
     }
 
 private:
+    void set_price(const string& symbol, double price) {
+        interop::TopicId id = interop::intern(symbol);
+        if (id >= prices_.size()) prices_.resize(id + 1);
+        if (prices_[id] == 0.0) symbols_.push_back(id);
+        prices_[id] = price;
+    }
+
+    bool has_price(interop::TopicId id) const {
+        return id < prices_.size() && prices_[id] != 0.0;
+    }
+
     void on_subscribe(const msg::Subscribe* m) noexcept {
-        string topic(m->topic.begin(),
-            find(m->topic.begin(), m->topic.end(), '\0'));
+        // The sender is the Rust actor's proxy (or a C++ actor)
+        auto* sender = get_reply_to();
+        if (!sender) {
+            cerr << "[C++ Publisher] Subscribe with no sender!" << endl;
+            return;
+        }
 
-        // Sender name comes from the message routing
-        string sender_name = "rust_price_monitor";
+        cout << "[C++ Publisher] " << sender->name
+             << " subscribing to '" << m->topic_name() << "'" << endl;
 
-        cout << "[C++ Publisher] " << sender_name
-             << " subscribing to '" << topic << "'" << endl;
+        feed_.subscribe(m->topic, sender);
 
-        auto& subscriber = subscribers_[sender_name];
-        if (!subscriber.ref) {  // Check if ref is valid
-            subscriber.name = sender_name;
-            // Get ActorRef from manager - works for C++ or Rust actors!
-            subscriber.ref = manager_->get_ref(sender_name);
-        }
+        // Send initial price to the new subscriber only
+        if (has_price(m->topic)) {
+            cout << "[C++ Publisher] Sending " << m->topic_name() << " @ $"
+                 << fixed << setprecision(2) << prices_[m->topic] << endl;
+            sender->send(new msg::MarketUpdate(make_update(m->topic)), this);
 
-        auto& topics = subscriber.topics;
-        if (find(topics.begin(), topics.end(), topic) == topics.end()) {
-            topics.push_back(topic);
-        }
+            // And a book snapshot - only the levels it has cross the FFI
+            sender->send(make_book(m->topic, 8), this);
 
-        // Send initial price
-        auto it = prices_.find(topic);
-        if (it != prices_.end()) {
-            send_update(subscriber, topic, it->second);
+            // Rust subscribers also get a depth snapshot written straight
+            // into a Rust-owned buffer, which is handed over without a copy
+            if (interop::rust_handle_of(sender) >= 0) {
+                send_depth(interop::RustActorIF(sender->name, name), m->topic);
+            }
         }
     }
 
     void on_unsubscribe(const msg::Unsubscribe* m) noexcept {
-        string topic(m->topic.begin(),
-            find(m->topic.begin(), m->topic.end(), '\0'));
+        auto* sender = get_reply_to();
+        if (!sender) return;
 
-        string sender_name = "rust_price_monitor";
+        cout << "[C++ Publisher] " << sender->name
+             << " unsubscribing from '" << m->topic_name() << "'" << endl;
 
-        cout << "[C++ Publisher] " << sender_name
-             << " unsubscribing from '" << topic << "'" << endl;
-
-        auto it = subscribers_.find(sender_name);
-        if (it != subscribers_.end()) {
-            auto& topics = it->second.topics;
-            topics.erase(remove(topics.begin(), topics.end(), topic), topics.end());
-        }
+        feed_.unsubscribe(m->topic, sender);
     }
 
-    void send_update(SubscriberInfo& sub, const string& symbol, double price) {
-        auto* update = new msg::MarketUpdate;
-        fill(update->symbol.begin(), update->symbol.end(), '\0');
-        copy(symbol.begin(),
-             symbol.begin() + min(symbol.size(), update->symbol.size() - 1),
-             update->symbol.begin());
-
-        update->price = price;
-        update->timestamp = static_cast<int64_t>(time(nullptr)) * 1000;
-        update->volume = rand() % 10000;
+    msg::MarketUpdate make_update(interop::TopicId id) const {
+        msg::MarketUpdate update;
+        update.symbol = id;
+        update.price = prices_[id];
+        update.timestamp = static_cast<int64_t>(time(nullptr)) * 1000;
+        update.volume = rand() % 10000;
+        return update;
+    }
 
-        cout << "[C++ Publisher] Sending " << symbol << " @ $"
-             << fixed << setprecision(2) << price << endl;
+    void send_depth(const interop::RustActorIF& subscriber, interop::TopicId id) const {
+        auto depth = interop::RustOwned<msg::MarketDepth>::alloc();
+        if (!depth) return;
+        depth->symbol = id;
+        depth->num_levels = 3;
+        for (int i = 0; i < depth->num_levels; i++) {
+            depth->bid_prices[i] = prices_[id] - 0.01 * (i + 1);
+            depth->ask_prices[i] = prices_[id] + 0.01 * (i + 1);
+            depth->bid_sizes[i] = 100 * (i + 1);
+            depth->ask_sizes[i] = 100 * (i + 1);
+        }
+        subscriber.send_owned(std::move(depth));
+    }
 
-        // Use ActorRef::send() - works for C++ or Rust actors!
-        sub.ref.send(update, this);
+    msg::OrderBook* make_book(interop::TopicId id, int depth) const {
+        auto* book = new msg::OrderBook();
+        book->symbol = id;
+        book->timestamp = static_cast<int64_t>(time(nullptr)) * 1000;
+        book->venue = "XNAS";
+        for (int i = 1; i <= depth; i++) {
+            book->bid_prices.push_back(prices_[id] - 0.01 * i);
+            book->bid_sizes.push_back(100 * i);
+            book->ask_prices.push_back(prices_[id] + 0.01 * i);
+            book->ask_sizes.push_back(100 * i);
+        }
+        return book;
     }
 };
 
@@ -201,7 +224,7 @@ int main() {
     create_rust_manager();
 
     // 4. Register rust_price_monitor actor with Rust Manager
-    void* rust_mgr = register_rust_subscriber();
+    const void* rust_mgr = cpp_mgr.manage_rust("rust_price_monitor", rust_actor_factory("RustSubscriber"));
 
     // 5. Initialize Rust actor bridge with Manager pointer
     rust_actor_init(rust_mgr);
@@ -219,6 +242,9 @@ int main() {
     //    RustSubscriber receives Start, sends Subscribe to C++
     rust_manager_init();
 
+    // 8. Build the actor directory - later lookups are one local probe
+    cpp_mgr.build_directory();
+
     // Give Rust time to subscribe
     this_thread::sleep_for(chrono::milliseconds(100));
 
@@ -229,17 +255,13 @@ int main() {
         this_thread::sleep_for(chrono::milliseconds(100));
     }
 
-    cpp_mgr.end();
+    // 9. The feed terminated the C++ Manager after its third round; let the
+    //    Rust subscriber handle every update it was sent, then stop it
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DRAIN, 100, INTEROP_RUNTIME_CPP};
+    interop_shutdown(&shutdown);
 
     cout << endl;
-    cout << "[Main] Shutting down..." << endl;
-
-    // Shutdown Rust Manager
-    rust_manager_end();
-
-    // Cleanup
-    rust_actor_shutdown();
-    cpp_actor_shutdown();
+    cout << "[Main] Shut down" << endl;
 
     return 0;
 }
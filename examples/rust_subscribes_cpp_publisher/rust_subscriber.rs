@@ -12,7 +12,8 @@
 use actors::{handle_messages, ActorContext, ActorRef, ManagerHandle};
 use actors::messages::Start;
 
-use crate::interop_messages::{Subscribe, Unsubscribe, MarketUpdate, MarketDepth};
+use crate::interop_messages::{Subscribe, Unsubscribe, MarketUpdate, MarketDepth, OrderBook};
+use crate::interop_symbols::{self, InteropSymbol};
 use crate::rust_manager_ffi::get_actor_ref;
 
 /// Price Monitor - subscribes to price feed and monitors updates
@@ -21,8 +22,8 @@ pub struct RustSubscriber {
     publisher: Option<ActorRef>,
     /// Count of updates received
     update_count: i32,
-    /// Subscribed topics
-    subscribed_topics: Vec<String>,
+    /// Subscribed topics (interned symbol IDs)
+    subscribed_topics: Vec<InteropSymbol>,
     #[allow(dead_code)]
     manager_handle: ManagerHandle,
 }
@@ -57,61 +58,62 @@ impl RustSubscriber {
     pub fn subscribe(&mut self, symbol: &str) {
         println!("[Rust Subscriber] Subscribing to {}", symbol);
 
-        let mut sub = Subscribe {
-            topic: [0u8; 32],
-        };
-
-        // Copy symbol to fixed-size array
-        let bytes = symbol.as_bytes();
-        let copy_len = bytes.len().min(31);
-        sub.topic[..copy_len].copy_from_slice(&bytes[..copy_len]);
+        // Intern once - the publisher and updates carry the same ID
+        let topic = interop_symbols::intern(symbol);
+        let sub = Subscribe { topic };
 
         // Send via ActorRef - location transparent!
         if let Some(publisher) = self.get_publisher() {
             publisher.send(Box::new(sub), None);
         }
-        self.subscribed_topics.push(symbol.to_string());
+        self.subscribed_topics.push(topic);
     }
 
     /// Handle incoming MarketUpdate message
     fn on_market_update(&mut self, msg: &MarketUpdate, _ctx: &mut ActorContext) {
+        // Filter on the symbol ID - an integer compare, no string work
+        if !self.subscribed_topics.contains(&msg.symbol) {
+            return;
+        }
         self.update_count += 1;
 
-        // Extract symbol from fixed-size array
-        let symbol = std::str::from_utf8(&msg.symbol)
-            .unwrap_or("")
-            .trim_end_matches('\0');
-
         println!(
             "[Rust Subscriber] Update #{}: {} @ {:.2} vol={} ts={}",
-            self.update_count, symbol, msg.price, msg.volume, msg.timestamp
+            self.update_count, msg.symbol_name(), msg.price, msg.volume, msg.timestamp
         );
 
         // After 10 updates, unsubscribe from first topic
         if self.update_count == 10 && !self.subscribed_topics.is_empty() {
             let topic = self.subscribed_topics.remove(0);
 
-            let mut unsub = Unsubscribe {
-                topic: [0u8; 32],
-            };
-            let bytes = topic.as_bytes();
-            let copy_len = bytes.len().min(31);
-            unsub.topic[..copy_len].copy_from_slice(&bytes[..copy_len]);
-
             if let Some(publisher) = self.get_publisher() {
-                publisher.send(Box::new(unsub), None);
+                publisher.send(Box::new(Unsubscribe { topic }), None);
             }
-            println!("[Rust Subscriber] Unsubscribed from {}", topic);
+            println!(
+                "[Rust Subscriber] Unsubscribed from {}",
+                interop_symbols::name(topic).unwrap_or("")
+            );
+        }
+    }
+
+    /// Handle incoming OrderBook message (variable-length fields - the book
+    /// owns Vecs with exactly as many levels as the publisher sent)
+    fn on_order_book(&mut self, msg: &OrderBook, _ctx: &mut ActorContext) {
+        println!(
+            "[Rust Subscriber] Order book for {} on {}: {} bids, {} asks",
+            msg.symbol_name(), msg.venue, msg.bid_prices.len(), msg.ask_prices.len()
+        );
+        if let (Some(bid), Some(ask)) = (msg.bid_prices.first(), msg.ask_prices.first()) {
+            println!(
+                "  Best: bid {:.2} x {} | ask {:.2} x {}",
+                bid, msg.bid_sizes[0], ask, msg.ask_sizes[0]
+            );
         }
     }
 
     /// Handle incoming MarketDepth message (demonstrates array handling)
     fn on_market_depth(&mut self, msg: &MarketDepth, _ctx: &mut ActorContext) {
-        let symbol = std::str::from_utf8(&msg.symbol)
-            .unwrap_or("")
-            .trim_end_matches('\0');
-
-        println!("[Rust Subscriber] Market Depth for {}:", symbol);
+        println!("[Rust Subscriber] Market Depth for {}:", msg.symbol_name());
         for i in 0..msg.num_levels as usize {
             println!(
                 "  Level {}: bid {:.2} x {} | ask {:.2} x {}",
@@ -129,5 +131,6 @@ impl RustSubscriber {
 handle_messages!(RustSubscriber,
     Start => on_start,
     MarketUpdate => on_market_update,
-    MarketDepth => on_market_depth
+    MarketDepth => on_market_depth,
+    OrderBook => on_order_book
 );
@@ -50,6 +50,14 @@ https://opensource.org/licenses/MIT
  * - Use fixed-width integers (int32_t, int64_t, not int/long)
  * - Use int32_t for booleans (1=true, 0=false)
  * - Use interop_string for strings (fixed-size, no heap)
+ * - Use interop_symbol for names that are filtered or routed on
+ *   (topics, tickers) - an interned ID, so compares are integer compares
+ * - Use INTEROP_VIEW for variable-length strings and arrays - only the
+ *   used elements are copied
+ * - Use INTEROP_ALIGN(64) on messages streamed at high rates, so each one
+ *   starts on its own cache line
+ * - Use INTEROP_CONFLATE(key) on plain-data messages where only the latest
+ *   value per key matters (quotes, depth snapshots)
  * - Message IDs start at 1000 to avoid conflicts with internal messages
  */
 
@@ -64,6 +72,42 @@ typedef struct {
     uint32_t len;
 } interop_string;
 
+/* Interned name: an ID from the symbol table shared by C++ and Rust
+ * (InteropSymbols.hpp / interop_symbols.rs). 0 means "no symbol". */
+typedef uint32_t interop_symbol;
+
+#define INTEROP_NO_SYMBOL 0
+
+/* Bounded variable-length field: a (pointer, length) view of at most max
+ * elements. char views are strings; other element types are arrays.
+ * Expands to two members: const type* name; uint32_t name_len;
+ *
+ * Lifetime: the view borrows the sender's buffer for the duration of the
+ * FFI call only. The receiving bridge copies the used elements into the
+ * message it delivers (std::vector/std::string, Vec/String), which owns
+ * them from then on. Longer values are truncated to max. */
+#define INTEROP_VIEW(type, name, max) const type* name; uint32_t name##_len
+
+/* Struct alignment: typedef struct INTEROP_ALIGN(64) { ... } Name;
+ * The generated C++ and Rust types get the same alignment, so pooled
+ * messages, batch items and ring slots all start on an n-byte boundary and
+ * never share a cache line with their neighbours. The size rounds up to a
+ * multiple of n. n is a power of two, at most 64. */
+#if defined(_MSC_VER)
+#define INTEROP_ALIGN(n) __declspec(align(n))
+#else
+#define INTEROP_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+/* Conflation: INTEROP_MESSAGE(Name, id) INTEROP_CONFLATE(key) typedef ...
+ * Sends of this type to an actor are conflated per value of `key` (an
+ * interop_symbol or 32-bit integer field): while one is queued, later ones
+ * overwrite the latest value in place instead of queueing, and the actor
+ * is sent that value once it has handled the queued one. At most one
+ * message per key is queued, however fast it is sent. Plain data only;
+ * parsed by the code generator. */
+#define INTEROP_CONFLATE(key)
+
 /* ============================================================
  * Message Definitions
  * ============================================================ */
@@ -97,17 +141,19 @@ typedef struct {
 
 INTEROP_MESSAGE(Subscribe, 1010)
 typedef struct {
-    char topic[32];
+    interop_symbol topic;
 } Subscribe;
 
 INTEROP_MESSAGE(Unsubscribe, 1011)
 typedef struct {
-    char topic[32];
+    interop_symbol topic;
 } Unsubscribe;
 
+/* Streamed per tick - one cache line each */
 INTEROP_MESSAGE(MarketUpdate, 1012)
-typedef struct {
-    char symbol[8];
+INTEROP_CONFLATE(symbol)
+typedef struct INTEROP_ALIGN(64) {
+    interop_symbol symbol;
     double price;
     int64_t timestamp;
     int32_t volume;
@@ -118,8 +164,9 @@ typedef struct {
  * ============================================================ */
 
 INTEROP_MESSAGE(MarketDepth, 1013)
+INTEROP_CONFLATE(symbol)
 typedef struct {
-    char symbol[8];
+    interop_symbol symbol;
     int32_t num_levels;
     double bid_prices[5];
     double ask_prices[5];
@@ -127,4 +174,19 @@ typedef struct {
     int32_t ask_sizes[5];
 } MarketDepth;
 
+/* ============================================================
+ * Example: Variable-length fields
+ * ============================================================ */
+
+INTEROP_MESSAGE(OrderBook, 1014)
+typedef struct {
+    interop_symbol symbol;
+    int64_t timestamp;
+    INTEROP_VIEW(double, bid_prices, 1024);
+    INTEROP_VIEW(int32_t, bid_sizes, 1024);
+    INTEROP_VIEW(double, ask_prices, 1024);
+    INTEROP_VIEW(int32_t, ask_sizes, 1024);
+    INTEROP_VIEW(char, venue, 256);
+} OrderBook;
+
 #endif /* INTEROP_MESSAGES_H */
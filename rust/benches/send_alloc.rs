@@ -0,0 +1,217 @@
+//! Allocation-counting microbenchmark for the Rust -> C++ send path
+//!
+//! Run with: cd rust && cargo bench --bench send_alloc
+//!
+//! Links against stub C++ bridge symbols (defined below) so the Rust side
+//! can be measured on its own. Every allocation made while sending is
+//! counted by a wrapping global allocator; the benchmark fails if the
+//! steady-state path allocates at all.
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::ffi::CStr;
+use std::hint::black_box;
+use std::os::raw::{c_char, c_int, c_void};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::Instant;
+
+use actors_interop::rust_actor_bridge::rust_actor_init;
+use actors_interop::rust_manager_ffi::{cpp_send_fn, create_rust_manager, register_rust_actor, rust_actor_factory};
+use actors_interop::{CppActorIF, Ping};
+
+const ITERATIONS: usize = 1_000_000;
+
+// ============================================================================
+// Counting allocator
+// ============================================================================
+
+struct CountingAlloc;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
+// ============================================================================
+// Stub C++ bridge - one actor, "cpp_pong", at handle 0
+// ============================================================================
+
+static DELIVERED: AtomicUsize = AtomicUsize::new(0);
+
+fn deliver(msg_data: *const c_void) -> c_int {
+    black_box(msg_data);
+    DELIVERED.fetch_add(1, Ordering::Relaxed);
+    0
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_resolve(name: *const c_char) -> c_int {
+    if name.is_null() {
+        return -1;
+    }
+    match unsafe { CStr::from_ptr(name) }.to_bytes() {
+        b"cpp_pong" => 0,
+        _ => -1,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_name(handle: c_int) -> *const c_char {
+    match handle {
+        0 => c"cpp_pong".as_ptr(),
+        _ => std::ptr::null(),
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_send_h(
+    handle: c_int,
+    _sender_handle: c_int,
+    _msg_type: c_int,
+    msg_data: *const c_void,
+) -> c_int {
+    if handle != 0 {
+        return -1;
+    }
+    deliver(msg_data)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_send_batch(
+    handle: c_int,
+    _sender_handle: c_int,
+    _msg_type: c_int,
+    items: *const c_void,
+    _count: c_int,
+) -> c_int {
+    if handle != 0 {
+        return -1;
+    }
+    deliver(items)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_send(
+    _actor_name: *const c_char,
+    _sender_name: *const c_char,
+    _msg_type: c_int,
+    msg_data: *const c_void,
+) -> c_int {
+    deliver(msg_data)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_fast_send(
+    _actor_name: *const c_char,
+    _sender_name: *const c_char,
+    _msg_type: c_int,
+    msg_data: *const c_void,
+) -> c_int {
+    deliver(msg_data)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_exists(name: *const c_char) -> c_int {
+    (cpp_actor_resolve(name) >= 0) as c_int
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_fanout(
+    _sender_handle: c_int,
+    _msg_type: c_int,
+    items: *const c_void,
+    _count: c_int,
+    _offsets: *const c_int,
+    _handles: *const c_int,
+) -> c_int {
+    deliver(items)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_msg_alloc(_msg_type: c_int) -> *mut c_void {
+    std::ptr::null_mut()
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_msg_free(_msg_type: c_int, _msg: *mut c_void) {}
+
+#[no_mangle]
+pub extern "C" fn cpp_actor_send_owned(
+    handle: c_int,
+    _sender_handle: c_int,
+    _msg_type: c_int,
+    msg: *mut c_void,
+) -> c_int {
+    if handle != 0 {
+        return -1;
+    }
+    deliver(msg)
+}
+
+#[no_mangle]
+pub extern "C" fn cpp_stats_collect(_out: *mut c_void) {}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+/// Run `send` ITERATIONS times after one warm-up call (which may resolve and
+/// cache handles). Returns true if the measured loop made no allocations.
+fn run(label: &str, mut send: impl FnMut(i32) -> i32) -> bool {
+    assert_eq!(send(0), 0, "{}: warm-up send failed", label);
+
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    let start = Instant::now();
+    for i in 0..ITERATIONS {
+        black_box(send(i as i32));
+    }
+    let elapsed = start.elapsed();
+    let allocs = ALLOCATIONS.load(Ordering::Relaxed) - before;
+
+    println!(
+        "{:<16} {:>8.1} ns/msg  {:>6.3} allocs/msg  ({} allocs total)",
+        label,
+        elapsed.as_nanos() as f64 / ITERATIONS as f64,
+        allocs as f64 / ITERATIONS as f64,
+        allocs
+    );
+    allocs == 0
+}
+
+fn main() {
+    // A real Rust sender so the sender handle is resolved and cached too
+    create_rust_manager();
+    let ping = rust_actor_factory(c"RustPingActor".as_ptr());
+    rust_actor_init(register_rust_actor(c"rust_ping".as_ptr(), ping, std::ptr::null()));
+
+    println!("=== Rust -> C++ send path ({} messages) ===", ITERATIONS);
+
+    let mut ok = run("cpp_send_fn", |count| {
+        cpp_send_fn("cpp_pong", "rust_ping", &Ping { count })
+    });
+
+    let cpp_pong = CppActorIF::new("cpp_pong", Some("rust_ping"));
+    ok &= run("CppActorIF::send", |count| cpp_pong.send(&Ping { count }));
+
+    println!("delivered: {}", DELIVERED.load(Ordering::Relaxed));
+    if !ok {
+        eprintln!("FAIL: send path allocated");
+        std::process::exit(1);
+    }
+    println!("OK: zero allocations per message");
+}
@@ -0,0 +1,211 @@
+//! Actor directory - one name -> (runtime, handle) table shared by both
+//! runtimes (C++ reaches it through ActorDirectory.hpp)
+//!
+//! Actors are added as they are registered: C++ actors by
+//! InteropManager::manage() and interop::register_direct_actor(), Rust
+//! actors by register_rust_actors() and register_direct_actor(). Once both
+//! Managers are initialized, build() resolves every added name in its own
+//! runtime and publishes the table. From then on a lookup is one lock-free
+//! probe, and a miss is final - neither side asks the other over FFI.
+//! Actors imported from another process (ipc_channel) are added as remote.
+//!
+//! A published table is never modified. An actor added after build() is
+//! resolved at once and published in a copy; replaced tables are leaked,
+//! not freed, so readers need no lock or guard.
+
+use std::collections::HashMap;
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+use std::sync::atomic::{AtomicPtr, Ordering};
+use std::sync::Mutex;
+
+/// Where an actor lives (same layout as ActorDirectory.hpp)
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct InteropActorLocation {
+    /// RUNTIME_CPP, RUNTIME_RUST or RUNTIME_REMOTE
+    pub runtime: c_int,
+    /// Bridge handle in that runtime, as cpp_actor_resolve() / resolve() /
+    /// ipc_channel::resolve() return
+    pub handle: c_int,
+}
+
+pub const RUNTIME_CPP: c_int = 1;
+pub const RUNTIME_RUST: c_int = 2;
+/// In another process, reached through an IPC channel
+pub const RUNTIME_REMOTE: c_int = 3;
+
+type Table = HashMap<Box<str>, InteropActorLocation>;
+
+// The published table, null until build()
+static TABLE: AtomicPtr<Table> = AtomicPtr::new(ptr::null_mut());
+
+// Every added actor in order; the lock also serializes publishing
+static ADDED: Mutex<Vec<(String, c_int)>> = Mutex::new(Vec::new());
+
+/// Result of a directory lookup
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum Lookup {
+    Found(InteropActorLocation),
+    /// Built, and no actor has this name
+    Missing,
+    /// Not built yet - ask the bridges instead
+    NotBuilt,
+}
+
+pub fn lookup(name: &str) -> Lookup {
+    let table = TABLE.load(Ordering::Acquire);
+    if table.is_null() {
+        return Lookup::NotBuilt;
+    }
+    // SAFETY: published tables are never freed
+    match unsafe { &*table }.get(name) {
+        Some(&location) => Lookup::Found(location),
+        None => Lookup::Missing,
+    }
+}
+
+fn resolve(name: &str, runtime: c_int) -> c_int {
+    match runtime {
+        RUNTIME_CPP => crate::rust_manager_ffi::resolve_cpp(name),
+        RUNTIME_REMOTE => crate::ipc_channel::resolve(name),
+        _ => crate::rust_actor_bridge::resolve(name),
+    }
+}
+
+fn publish(table: Option<Table>) {
+    let table = table.map_or(ptr::null_mut(), |t| Box::into_raw(Box::new(t)));
+    // The old table is leaked: a reader may still be probing it
+    TABLE.store(table, Ordering::Release);
+}
+
+/// Add an actor. Before build() this only records the name; after, the actor
+/// is resolved and published at once. The first entry for a name wins.
+/// Returns 0, or -1 for an invalid name or runtime, or (once built) a name
+/// that does not resolve
+pub fn add(name: &str, runtime: c_int) -> c_int {
+    if name.is_empty() || !(RUNTIME_CPP..=RUNTIME_REMOTE).contains(&runtime) {
+        return -1;
+    }
+    let mut added = ADDED.lock().unwrap();
+    let table = TABLE.load(Ordering::Acquire);
+    if !table.is_null() {
+        // SAFETY: published tables are never freed
+        let current = unsafe { &*table };
+        if !current.contains_key(name) {
+            let handle = resolve(name, runtime);
+            if handle < 0 {
+                return -1;
+            }
+            let mut next = current.clone();
+            next.insert(name.into(), InteropActorLocation { runtime, handle });
+            publish(Some(next));
+        }
+    }
+    added.push((name.to_string(), runtime));
+    0
+}
+
+/// Resolve every added actor and publish the table. Call once both bridges
+/// are initialized and both Managers have run init().
+/// Returns the number of actors, or -1 (nothing published) if any added name
+/// does not resolve
+pub fn build() -> c_int {
+    let added = ADDED.lock().unwrap();
+    let mut table = Table::with_capacity(added.len());
+    for (name, runtime) in added.iter() {
+        if table.contains_key(name.as_str()) {
+            continue;
+        }
+        let handle = resolve(name, *runtime);
+        if handle < 0 {
+            return -1;
+        }
+        table.insert(name.as_str().into(), InteropActorLocation { runtime: *runtime, handle });
+    }
+    let count = table.len() as c_int;
+    publish(Some(table));
+    count
+}
+
+/// Resolve every added actor of `runtime` into its bridge's handle table, so
+/// a drain also reaches actors nothing has sent to yet. Names that do not
+/// resolve are skipped. Returns the number that resolved.
+pub fn resolve_added(runtime: c_int) -> c_int {
+    // Copied out: resolving may call into the other bridge
+    let names: Vec<String> = ADDED
+        .lock()
+        .unwrap()
+        .iter()
+        .filter(|(_, r)| *r == runtime)
+        .map(|(name, _)| name.clone())
+        .collect();
+    names.iter().filter(|name| resolve(name, runtime) >= 0).count() as c_int
+}
+
+/// Number of actors in the published table, or -1 before build()
+pub fn size() -> c_int {
+    let table = TABLE.load(Ordering::Acquire);
+    if table.is_null() {
+        -1
+    } else {
+        unsafe { &*table }.len() as c_int
+    }
+}
+
+/// Forget every actor - bridge shutdown invalidates their handles
+pub fn clear() {
+    let mut added = ADDED.lock().unwrap();
+    publish(None);
+    added.clear();
+}
+
+// ============================================================================
+// FFI - see ActorDirectory.hpp
+// ============================================================================
+
+fn c_str<'a>(name: *const c_char) -> Option<&'a str> {
+    if name.is_null() {
+        return None;
+    }
+    unsafe { CStr::from_ptr(name) }.to_str().ok()
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_add(name: *const c_char, runtime: c_int) -> c_int {
+    c_str(name).map_or(-1, |name| add(name, runtime))
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_build() -> c_int {
+    build()
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_find(name: *const c_char, out: *mut InteropActorLocation) -> c_int {
+    match c_str(name).map(lookup) {
+        Some(Lookup::Found(location)) => {
+            if !out.is_null() {
+                unsafe { *out = location };
+            }
+            0
+        }
+        _ => -1,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_resolve_added(runtime: c_int) -> c_int {
+    resolve_added(runtime)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_size() -> c_int {
+    size()
+}
+
+#[no_mangle]
+pub extern "C" fn interop_directory_clear() {
+    clear()
+}
@@ -0,0 +1,440 @@
+//! Shared worker pool - runs pooled actors of both runtimes on N pinned,
+//! work-stealing worker threads (C++ reaches this module through
+//! InteropPool.hpp)
+//!
+//! A pooled actor is a direct actor (see DirectActor, in either runtime)
+//! registered with register_pooled_actor(). Sends to its handle no longer
+//! run the handler on the sender's thread: the C struct is copied into the
+//! actor's inbox, and the actor is queued on its home worker if it was idle.
+//! A worker runs one actor at a time, to completion, through every message
+//! its inbox held when the batch started.
+//!
+//! Wakeups: a send to an actor that is already queued or running wakes no
+//! one. When the sender is itself a pool worker and the target's home is
+//! that worker - such as a C++ handler replying to a Rust actor beside it -
+//! the target is queued locally and runs after the current batch, with no
+//! wakeup at all. Otherwise the home worker is woken if parked, else one
+//! parked worker is woken to steal the actor. An idle worker steals from
+//! the back of the other workers' queues, and a stolen actor's home moves
+//! to the thief.
+
+use std::cell::Cell;
+use std::collections::VecDeque;
+use std::os::raw::{c_int, c_void};
+use std::ptr;
+use std::sync::atomic::{AtomicBool, AtomicPtr, AtomicU8, AtomicUsize, Ordering};
+use std::sync::{Mutex, OnceLock};
+use std::thread::{self, JoinHandle, Thread};
+use std::time::{Duration, Instant};
+
+use crate::actor_directory::{RUNTIME_CPP, RUNTIME_RUST};
+use crate::interop_messages::c_struct_size;
+use crate::rust_actor_bridge::{DIRECT_HANDLE, MAX_DIRECT_ACTORS};
+use crate::thread_placement::{Placement, MAX_CPUS};
+
+/// Most workers a pool can have
+pub const MAX_WORKERS: usize = 256;
+
+/// Pool configuration as passed from C++ (same layout as InteropPool.hpp)
+#[repr(C)]
+pub struct InteropPoolConfig {
+    /// Worker threads (0: one per CPU in `cpus`, or one if none are given)
+    pub workers: u32,
+    /// Worker i is pinned to cpus[i % num_cpus] (null or num_cpus = 0: not pinned)
+    pub cpus: *const c_int,
+    pub num_cpus: c_int,
+}
+
+// Pool states
+const RUNNING: u8 = 0;
+const DRAINING: u8 = 1;
+const STOPPED: u8 = 2;
+
+// ============================================================================
+// Actors
+// ============================================================================
+
+/// One cache line of inbox storage - C structs are copied in whole lines,
+/// so every one is aligned as the bridge expects
+#[derive(Clone, Copy)]
+#[repr(C, align(64))]
+struct Line([u8; 64]);
+
+struct Envelope {
+    msg_type: i32,
+    sender_handle: i32,
+    /// First line of the C struct
+    line: u32,
+}
+
+/// Messages queued to a pooled actor. A worker swaps the whole inbox for
+/// its own empty one, so steady state allocates nothing.
+#[derive(Default)]
+struct Inbox {
+    items: Vec<Envelope>,
+    lines: Vec<Line>,
+}
+
+impl Inbox {
+    fn push(&mut self, msg_type: i32, sender_handle: i32, data: *const c_void, size: usize) {
+        let at = self.lines.len();
+        self.lines.resize(at + size.div_ceil(64).max(1), Line([0; 64]));
+        unsafe { ptr::copy_nonoverlapping(data as *const u8, self.lines[at..].as_mut_ptr() as *mut u8, size) };
+        self.items.push(Envelope { msg_type, sender_handle, line: at as u32 });
+    }
+
+    fn clear(&mut self) {
+        self.items.clear();
+        self.lines.clear();
+    }
+}
+
+/// A pooled actor - kept for the life of the process, like its direct slot.
+/// Whoever sets `scheduled` queues it; only the worker running it clears it.
+struct PoolActor {
+    runtime: c_int,
+    handle: c_int,
+    inbox: Mutex<Inbox>,
+    scheduled: AtomicBool,
+    home: AtomicUsize,
+}
+
+static CPP_ACTORS: [AtomicPtr<PoolActor>; MAX_DIRECT_ACTORS] =
+    [const { AtomicPtr::new(ptr::null_mut()) }; MAX_DIRECT_ACTORS];
+static RUST_ACTORS: [AtomicPtr<PoolActor>; MAX_DIRECT_ACTORS] =
+    [const { AtomicPtr::new(ptr::null_mut()) }; MAX_DIRECT_ACTORS];
+
+/// The pool entry of a direct actor handle
+fn actor_slot(runtime: c_int, handle: c_int) -> Option<&'static AtomicPtr<PoolActor>> {
+    if handle < 0 || handle & DIRECT_HANDLE == 0 {
+        return None;
+    }
+    let table = match runtime {
+        RUNTIME_CPP => &CPP_ACTORS,
+        RUNTIME_RUST => &RUST_ACTORS,
+        _ => return None,
+    };
+    table.get((handle & !DIRECT_HANDLE) as usize)
+}
+
+fn pool_actor(runtime: c_int, handle: c_int) -> Option<&'static PoolActor> {
+    actor_slot(runtime, handle).and_then(|slot| unsafe { slot.load(Ordering::Acquire).as_ref() })
+}
+
+extern "C" {
+    fn cpp_actor_direct_run(handle: c_int, sender_handle: c_int, msg_type: c_int, msg_data: *const c_void) -> c_int;
+}
+
+/// Run the actor's handler on this worker
+fn deliver(actor: &PoolActor, envelope: &Envelope, data: *const c_void) -> c_int {
+    match actor.runtime {
+        RUNTIME_CPP => unsafe { cpp_actor_direct_run(actor.handle, envelope.sender_handle, envelope.msg_type, data) },
+        _ => crate::rust_actor_bridge::direct_run(actor.handle, envelope.sender_handle, envelope.msg_type, data),
+    }
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+struct Worker {
+    /// Actors ready to run - the owner pops the front, thieves the back
+    queue: Mutex<VecDeque<&'static PoolActor>>,
+    parked: AtomicBool,
+    thread: OnceLock<Thread>,
+}
+
+struct Pool {
+    workers: Box<[Worker]>,
+    state: AtomicU8,
+    /// Scheduled actors, queued or running - the pool is drained at 0
+    active: AtomicUsize,
+    next_home: AtomicUsize,
+}
+
+// Leaked on start - a send racing stop() may still hold it
+static POOL: AtomicPtr<Pool> = AtomicPtr::new(ptr::null_mut());
+static STARTED: AtomicBool = AtomicBool::new(false);
+static JOINS: Mutex<Vec<JoinHandle<()>>> = Mutex::new(Vec::new());
+
+thread_local! {
+    // Index of the worker running on this thread (usize::MAX: not a worker)
+    static WORKER: Cell<usize> = const { Cell::new(usize::MAX) };
+}
+
+fn running_pool() -> Option<&'static Pool> {
+    unsafe { POOL.load(Ordering::Acquire).as_ref() }
+}
+
+impl Pool {
+    /// Queue an actor whose `scheduled` flag the caller just set
+    fn schedule(&self, actor: &'static PoolActor) {
+        let home = actor.home.load(Ordering::Relaxed);
+        self.workers[home].queue.lock().unwrap().push_back(actor);
+        if WORKER.with(Cell::get) == home {
+            return;  // Runs after this worker's current batch - no wakeup
+        }
+        if !self.unpark(home) {
+            // Home is busy: let a parked worker steal it
+            if let Some(idle) = (0..self.workers.len()).find(|&w| w != home && self.workers[w].parked.load(Ordering::SeqCst)) {
+                self.unpark(idle);
+            }
+        }
+    }
+
+    /// Wake a parked worker - false if it was not parked
+    fn unpark(&self, index: usize) -> bool {
+        let worker = &self.workers[index];
+        if !worker.parked.swap(false, Ordering::SeqCst) {
+            return false;
+        }
+        if let Some(t) = worker.thread.get() {
+            t.unpark();
+        }
+        true
+    }
+
+    fn unpark_all(&self) {
+        for w in 0..self.workers.len() {
+            self.unpark(w);
+        }
+    }
+
+    /// The next actor for worker `index`: its own queue first, else one
+    /// stolen from the back of another's
+    fn next(&self, index: usize) -> Option<&'static PoolActor> {
+        if let Some(actor) = self.workers[index].queue.lock().unwrap().pop_front() {
+            return Some(actor);
+        }
+        let n = self.workers.len();
+        (1..n).find_map(|i| {
+            let actor = self.workers[(index + i) % n].queue.lock().unwrap().pop_back()?;
+            actor.home.store(index, Ordering::Relaxed);
+            Some(actor)
+        })
+    }
+
+    fn has_work(&self) -> bool {
+        self.workers.iter().any(|w| !w.queue.lock().unwrap().is_empty())
+    }
+
+    /// Run every message the actor's inbox holds, then requeue it here if
+    /// more arrived meanwhile, else mark it idle
+    fn run_batch(&self, index: usize, actor: &'static PoolActor, batch: &mut Inbox) {
+        std::mem::swap(&mut *actor.inbox.lock().unwrap(), batch);
+        for envelope in &batch.items {
+            let data = batch.lines[envelope.line as usize..].as_ptr() as *const c_void;
+            // A failed delivery (unknown type) drops the message
+            deliver(actor, envelope, data);
+        }
+        batch.clear();
+
+        actor.scheduled.store(false, Ordering::SeqCst);
+        let more = !actor.inbox.lock().unwrap().items.is_empty();
+        if more && !actor.scheduled.swap(true, Ordering::SeqCst) {
+            self.workers[index].queue.lock().unwrap().push_back(actor);
+        } else {
+            self.active.fetch_sub(1, Ordering::SeqCst);
+        }
+    }
+
+    fn run_worker(&'static self, index: usize, placement: Option<Placement>) {
+        if let Some(placement) = placement {
+            placement.apply_or_record();
+        }
+        WORKER.with(|w| w.set(index));
+        let worker = &self.workers[index];
+        let _ = worker.thread.set(thread::current());
+        let mut batch = Inbox::default();
+
+        while self.state.load(Ordering::SeqCst) != STOPPED {
+            if let Some(actor) = self.next(index) {
+                self.run_batch(index, actor, &mut batch);
+                continue;
+            }
+            // Park - re-checking after the flag is up, so a send that
+            // queued work before seeing it cannot be missed
+            worker.parked.store(true, Ordering::SeqCst);
+            if self.has_work() || self.state.load(Ordering::SeqCst) == STOPPED {
+                worker.parked.store(false, Ordering::SeqCst);
+                continue;
+            }
+            thread::park();
+            worker.parked.store(false, Ordering::SeqCst);
+        }
+    }
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+/// Start the pool. Returns 0, or -1 if a pool was already started in this
+/// process or the configuration is invalid
+///
+/// # Safety
+/// `config.cpus` must point to `config.num_cpus` ints, or be null.
+pub unsafe fn start(config: &InteropPoolConfig) -> i32 {
+    let cpus = if config.cpus.is_null() || config.num_cpus <= 0 {
+        &[][..]
+    } else {
+        std::slice::from_raw_parts(config.cpus, config.num_cpus as usize)
+    };
+    if cpus.iter().any(|&c| c < 0 || c as usize >= MAX_CPUS) {
+        return -1;
+    }
+    let workers = match config.workers as usize {
+        0 => cpus.len().max(1),
+        n => n,
+    };
+    if workers > MAX_WORKERS || STARTED.swap(true, Ordering::SeqCst) {
+        return -1;
+    }
+
+    let pool: &'static Pool = Box::leak(Box::new(Pool {
+        workers: (0..workers)
+            .map(|_| Worker { queue: Mutex::new(VecDeque::new()), parked: AtomicBool::new(false), thread: OnceLock::new() })
+            .collect(),
+        state: AtomicU8::new(RUNNING),
+        active: AtomicUsize::new(0),
+        next_home: AtomicUsize::new(0),
+    }));
+    POOL.store(pool as *const Pool as *mut Pool, Ordering::Release);
+
+    let mut joins = JOINS.lock().unwrap();
+    for index in 0..workers {
+        let placement = (!cpus.is_empty()).then(|| Placement { cpus: vec![cpus[index % cpus.len()] as usize], priority: 0 });
+        let spawned = thread::Builder::new()
+            .name(format!("interop-pool-{}", index))
+            .spawn(move || pool.run_worker(index, placement));
+        match spawned {
+            Ok(join) => joins.push(join),
+            Err(_) => {
+                drop(joins);
+                stop(0);
+                return -1;
+            }
+        }
+    }
+    0
+}
+
+/// Put a direct actor handle on the pool, homed on `worker` (-1: round
+/// robin). Returns 0, or -1 if the pool is not running or the handle is not
+/// a direct actor's. Called by both register_pooled_actor()s before the
+/// actor's name is published, so no sender runs it inline meanwhile.
+pub fn adopt(runtime: c_int, handle: c_int, worker: i32) -> i32 {
+    let (pool, slot) = match (running_pool(), actor_slot(runtime, handle)) {
+        (Some(p), Some(s)) => (p, s),
+        _ => return -1,
+    };
+    let n = pool.workers.len();
+    let home = if worker >= 0 { worker as usize % n } else { pool.next_home.fetch_add(1, Ordering::Relaxed) % n };
+    let actor = Box::new(PoolActor {
+        runtime,
+        handle,
+        inbox: Mutex::new(Inbox::default()),
+        scheduled: AtomicBool::new(false),
+        home: AtomicUsize::new(home),
+    });
+    match slot.compare_exchange(ptr::null_mut(), Box::into_raw(actor), Ordering::AcqRel, Ordering::Acquire) {
+        Ok(_) => 0,
+        Err(_) => -1,  // Already pooled (the Box is leaked - registration is cold)
+    }
+}
+
+/// Queue a message to a pooled actor - called by the bridges for sends to
+/// a pooled handle. Returns 0, -1 if the actor is not pooled or the pool
+/// is stopped, -2 if the type cannot be copied (unknown, or view fields)
+pub fn post(runtime: c_int, handle: c_int, sender_handle: c_int, msg_type: c_int, msg_data: *const c_void) -> i32 {
+    let (pool, actor) = match (running_pool(), pool_actor(runtime, handle)) {
+        (Some(p), Some(a)) => (p, a),
+        _ => return -1,
+    };
+    if msg_data.is_null() || pool.state.load(Ordering::Acquire) == STOPPED {
+        return -1;
+    }
+    let size = match c_struct_size(msg_type) {
+        Some(s) => s,
+        None => return -2,
+    };
+    actor.inbox.lock().unwrap().push(msg_type, sender_handle, msg_data, size);
+
+    // Counted first, so a drain never sees 0 while this actor is being queued
+    pool.active.fetch_add(1, Ordering::SeqCst);
+    if actor.scheduled.swap(true, Ordering::SeqCst) {
+        pool.active.fetch_sub(1, Ordering::SeqCst);
+        return 0;  // Already queued or running - it will see the message
+    }
+    pool.schedule(actor);
+    0
+}
+
+/// Stop the pool: wait up to `drain_timeout_ms` for every queued message to
+/// be handled (0: do not wait), then stop and join the workers. Returns the
+/// number of pooled actors that still had messages, or -1 if no pool runs
+pub fn stop(drain_timeout_ms: u32) -> i32 {
+    let pool = match running_pool() {
+        Some(p) => p,
+        None => return -1,
+    };
+    if pool.state.swap(DRAINING, Ordering::SeqCst) != RUNNING {
+        return -1;  // Another stop() is in progress
+    }
+    let deadline = Instant::now() + Duration::from_millis(drain_timeout_ms as u64);
+    while pool.active.load(Ordering::SeqCst) > 0 && Instant::now() < deadline {
+        thread::sleep(Duration::from_micros(100));
+    }
+
+    pool.state.store(STOPPED, Ordering::SeqCst);
+    pool.unpark_all();
+    for join in JOINS.lock().unwrap().drain(..) {
+        let _ = join.join();
+    }
+    POOL.store(ptr::null_mut(), Ordering::Release);
+    pool.active.load(Ordering::SeqCst) as i32
+}
+
+/// Index of the pool worker running on this thread, if any
+pub fn current_worker() -> Option<usize> {
+    let w = WORKER.with(Cell::get);
+    (w != usize::MAX).then_some(w)
+}
+
+// ============================================================================
+// C API (InteropPool.hpp)
+// ============================================================================
+
+#[no_mangle]
+pub extern "C" fn interop_pool_start(config: *const InteropPoolConfig) -> c_int {
+    match unsafe { config.as_ref() } {
+        Some(c) => unsafe { start(c) },
+        None => -1,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn interop_pool_adopt(runtime: c_int, handle: c_int, worker: c_int) -> c_int {
+    adopt(runtime, handle, worker)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_pool_post(
+    runtime: c_int,
+    handle: c_int,
+    sender_handle: c_int,
+    msg_type: c_int,
+    msg_data: *const c_void,
+) -> c_int {
+    post(runtime, handle, sender_handle, msg_type, msg_data)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_pool_stop(drain_timeout_ms: u32) -> c_int {
+    stop(drain_timeout_ms)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_pool_worker() -> c_int {
+    current_worker().map_or(-1, |w| w as c_int)
+}
@@ -0,0 +1,590 @@
+//! IPC channels - interop rings in shared memory, between processes
+//!
+//! A process exports some of its actors (C++ or Rust) on a named channel:
+//! one POSIX shared-memory segment holding one inbound InteropRing per
+//! actor. Slots carry the interop_messages.h C structs as they are, so the
+//! wire format is the in-process one and nothing is serialized. A pump
+//! thread per ring hands each slot to its actor through the bridge.
+//!
+//! Another process imports the channel and its actors become remote actors:
+//! InteropManager::get_ref() and get_actor_ref() find them like any other
+//! actor (C++ reaches this module through IpcChannel.hpp). A ring has one
+//! producer, so the importing process's senders share a producer lock.
+//! Replies do not cross processes - a remote actor answers through a
+//! channel the sender's process exports.
+
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int, c_void};
+use std::ptr;
+use std::sync::atomic::{AtomicPtr, AtomicU32, AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::thread::JoinHandle;
+
+use crate::actor_directory::{self, InteropActorLocation, Lookup, RUNTIME_CPP, RUNTIME_REMOTE, RUNTIME_RUST};
+use crate::interop_ring::{init_ring, ring_bytes, InteropRing, RingPayload, RingSlot};
+use crate::interop_wire::SCHEMA_HASH;
+
+/// Actors one channel can export
+pub const MAX_CHANNEL_ACTORS: usize = 64;
+/// Remote actors one process can import, over all channels
+pub const MAX_REMOTES: usize = 256;
+/// Longest actor name, NUL included (the C++ Actor name buffer)
+pub const NAME_LEN: usize = 64;
+
+const MAGIC: u32 = 0x4950_4332; // "IPC2"
+
+/// Segment header - the exporter's rings follow it, ring_bytes apart
+#[repr(C, align(64))]
+struct ChannelHeader {
+    magic: u32,
+    /// size_of::<RingSlot>() in the exporter
+    slot_size: u32,
+    /// interop_wire::SCHEMA_HASH in the exporter - both processes must be
+    /// built from the same interop_messages.h
+    schema_hash: u64,
+    num_rings: u32,
+    ring_bytes: u32,
+    exporter_pid: i32,
+    /// Set once every ring is laid out
+    ready: AtomicU32,
+    names: [[u8; NAME_LEN]; MAX_CHANNEL_ACTORS],
+}
+
+fn segment_bytes(num_rings: usize, ring_bytes: usize) -> usize {
+    std::mem::size_of::<ChannelHeader>() + num_rings * ring_bytes
+}
+
+fn ring_at(header: *mut ChannelHeader, i: usize) -> *mut u8 {
+    let rb = unsafe { (*header).ring_bytes } as usize;
+    (header as *mut u8).wrapping_add(segment_bytes(i, rb))
+}
+
+// ============================================================================
+// Remote actors - imported from another process
+// ============================================================================
+
+/// An imported actor (same layout as IpcChannel.hpp)
+#[repr(C)]
+pub struct InteropRemote {
+    /// The actor's inbound ring, in this process's mapping of the channel
+    pub ring: *const InteropRing,
+    /// Producer lock - every sender in this process takes it to push
+    lock: AtomicU32,
+    /// Set by interop_ipc_close(), or once the exporter is found dead
+    closed: AtomicU32,
+    exporter_pid: i32,
+    name: [u8; NAME_LEN],
+}
+
+const _: () = assert!(std::mem::size_of::<InteropRemote>() == 88);
+
+// SAFETY: the ring is only pushed to under `lock`; the rest is atomic or fixed
+unsafe impl Sync for InteropRemote {}
+unsafe impl Send for InteropRemote {}
+
+impl InteropRemote {
+    fn ring(&self) -> &InteropRing {
+        // SAFETY: imported mappings are never unmapped
+        unsafe { &*self.ring }
+    }
+
+    pub fn name(&self) -> &str {
+        let len = self.name.iter().position(|&b| b == 0).unwrap_or(NAME_LEN);
+        std::str::from_utf8(&self.name[..len]).unwrap_or("")
+    }
+
+    /// Push one plain-data message, spinning while the ring is full
+    /// Returns 0, -1 if the channel is closed or the exporter is gone,
+    /// -2 if the type cannot be queued, -3 on downcast failure
+    pub fn send(&self, msg: &dyn actors::Message) -> i32 {
+        while self.lock.compare_exchange_weak(0, 1, Ordering::Acquire, Ordering::Relaxed).is_err() {
+            std::hint::spin_loop();
+        }
+        let rc = if self.wait_for_space() { self.ring().push_message(msg, -1) } else { -1 };
+        self.lock.store(0, Ordering::Release);
+        rc
+    }
+
+    /// Caller holds the producer lock, so space stays free once seen
+    fn wait_for_space(&self) -> bool {
+        let mut spins = 0u32;
+        while self.ring().is_full() {
+            if self.closed.load(Ordering::Relaxed) != 0 || self.ring().is_closed() {
+                return false;
+            }
+            spins = spins.wrapping_add(1);
+            if spins % 1024 == 0 && !sys::alive(self.exporter_pid) {
+                self.closed.store(1, Ordering::Relaxed);
+                return false;
+            }
+            std::hint::spin_loop();
+        }
+        self.closed.load(Ordering::Relaxed) == 0 && !self.ring().is_closed()
+    }
+}
+
+// Append-only; a slot is published (Release) after it is filled in
+static REMOTES: [AtomicPtr<InteropRemote>; MAX_REMOTES] =
+    [const { AtomicPtr::new(ptr::null_mut()) }; MAX_REMOTES];
+static REMOTE_COUNT: AtomicUsize = AtomicUsize::new(0);
+
+/// The remote actor behind a handle from resolve()
+pub fn remote(handle: i32) -> Option<&'static InteropRemote> {
+    let index = usize::try_from(handle).ok()?;
+    if index >= REMOTE_COUNT.load(Ordering::Acquire) {
+        return None;  // Not published by import()
+    }
+    let slot = REMOTES.get(index)?;
+    // SAFETY: remotes are never freed
+    unsafe { slot.load(Ordering::Acquire).as_ref() }
+}
+
+/// Handle of an imported actor, or -1 (a local scan - no lock, no FFI)
+pub fn resolve(name: &str) -> i32 {
+    let count = REMOTE_COUNT.load(Ordering::Acquire).min(MAX_REMOTES);
+    (0..count as i32)
+        .find(|&h| remote(h).is_some_and(|r| r.name() == name))
+        .unwrap_or(-1)
+}
+
+// ============================================================================
+// Channels
+// ============================================================================
+
+struct Export {
+    channel: String,
+    segment: sys::Segment,
+    pumps: Vec<JoinHandle<()>>,
+}
+
+struct Import {
+    channel: String,
+    remotes: Vec<i32>,
+}
+
+// Export and import bookkeeping - channel setup and teardown are cold
+static EXPORTS: Mutex<Vec<Export>> = Mutex::new(Vec::new());
+static IMPORTS: Mutex<Vec<Import>> = Mutex::new(Vec::new());
+
+/// Where a local actor lives - the directory if built, else the bridges
+fn resolve_local(name: &str) -> Option<InteropActorLocation> {
+    if let Lookup::Found(location) = actor_directory::lookup(name) {
+        return (location.runtime != RUNTIME_REMOTE).then_some(location);
+    }
+    let handle = crate::rust_actor_bridge::resolve(name);
+    if handle >= 0 {
+        return Some(InteropActorLocation { runtime: RUNTIME_RUST, handle });
+    }
+    let handle = crate::rust_manager_ffi::resolve_cpp(name);
+    (handle >= 0).then_some(InteropActorLocation { runtime: RUNTIME_CPP, handle })
+}
+
+extern "C" {
+    fn cpp_actor_send_h(handle: c_int, sender_handle: c_int, msg_type: c_int, msg_data: *const c_void) -> c_int;
+}
+
+/// Drain one ring into its actor until the channel closes
+fn pump(ring: &InteropRing, target: InteropActorLocation) {
+    while ring.wait() {
+        ring.poll(usize::MAX, |slot: &RingSlot| {
+            let data = &slot.payload as *const RingPayload as *const c_void;
+            // A failed delivery (actor gone, unknown type) drops the message
+            match target.runtime {
+                RUNTIME_CPP => unsafe { cpp_actor_send_h(target.handle, -1, slot.msg_type, data) },
+                _ => crate::rust_actor_bridge::rust_actor_send_h(target.handle, -1, slot.msg_type, data),
+            };
+        });
+    }
+}
+
+/// Export local actors on `channel`, one ring of `capacity` slots each
+/// (rounded up to a power of two), and start their pumps.
+/// Returns 0, or -1 if a name is invalid, repeats or does not resolve, or
+/// the channel already exists
+pub fn export(channel: &str, actors: &[&str], capacity: u32, wakeup: i32) -> i32 {
+    if actors.is_empty() || actors.len() > MAX_CHANNEL_ACTORS {
+        return -1;
+    }
+    let mut targets = Vec::with_capacity(actors.len());
+    for (i, name) in actors.iter().enumerate() {
+        if name.is_empty() || name.len() >= NAME_LEN || actors[..i].contains(name) {
+            return -1;
+        }
+        match resolve_local(name) {
+            Some(location) => targets.push(location),
+            None => return -1,
+        }
+    }
+    let capacity = match capacity.max(2).checked_next_power_of_two() {
+        Some(c) => c,
+        None => return -1,
+    };
+
+    let mut exports = EXPORTS.lock().unwrap();
+    if exports.iter().any(|e| e.channel == channel) {
+        return -1;
+    }
+    let rb = ring_bytes(capacity).next_multiple_of(64);
+    let segment = match sys::Segment::create(channel, segment_bytes(actors.len(), rb)) {
+        Some(s) => s,
+        None => return -1,
+    };
+    let header = segment.ptr as *mut ChannelHeader;
+    let mut rings = Vec::with_capacity(actors.len());
+    unsafe {
+        // SAFETY: a fresh, zeroed mapping no other process reads before `ready`
+        let h = &mut *header;
+        h.magic = MAGIC;
+        h.slot_size = std::mem::size_of::<RingSlot>() as u32;
+        h.schema_hash = SCHEMA_HASH;
+        h.num_rings = actors.len() as u32;
+        h.ring_bytes = rb as u32;
+        h.exporter_pid = sys::pid();
+        for (i, name) in actors.iter().enumerate() {
+            h.names[i][..name.len()].copy_from_slice(name.as_bytes());
+        }
+        for i in 0..actors.len() {
+            rings.push(init_ring(ring_at(header, i), capacity, wakeup));
+        }
+        h.ready.store(1, Ordering::Release);
+    }
+
+    let mut pumps = Vec::with_capacity(actors.len());
+    for ((ring, target), name) in rings.into_iter().zip(targets).zip(actors) {
+        let spawned = std::thread::Builder::new()
+            .name(format!("ipc:{}", name))
+            // SAFETY: the segment is unmapped only after this thread is joined
+            .spawn(move || pump(ring, target));
+        match spawned {
+            Ok(thread) => pumps.push(thread),
+            Err(_) => {
+                // Segment is dropped (unlinked) after the started pumps stop
+                close_export(Export { channel: channel.to_string(), segment, pumps });
+                return -1;
+            }
+        }
+    }
+    exports.push(Export { channel: channel.to_string(), segment, pumps });
+    0
+}
+
+/// Import every actor `channel` exports. Each becomes a remote actor and is
+/// added to the actor directory.
+/// Returns the number of actors, or -1 if there is no such channel, it was
+/// built from different message definitions (interop_wire::SCHEMA_HASH),
+/// or it is already imported
+pub fn import(channel: &str) -> i32 {
+    let mut imports = IMPORTS.lock().unwrap();
+    if imports.iter().any(|i| i.channel == channel) {
+        return -1;
+    }
+    let segment = match sys::Segment::open(channel) {
+        Some(s) => s,
+        None => return -1,
+    };
+    let header = segment.ptr as *mut ChannelHeader;
+    let (num_rings, pid) = unsafe {
+        let h = &*header;
+        if segment.len < std::mem::size_of::<ChannelHeader>()
+            || h.ready.load(Ordering::Acquire) == 0
+            || h.magic != MAGIC
+            || h.slot_size != std::mem::size_of::<RingSlot>() as u32
+            || h.schema_hash != SCHEMA_HASH
+            || h.num_rings as usize > MAX_CHANNEL_ACTORS
+            || (h.ring_bytes as usize) < std::mem::size_of::<InteropRing>()
+            || segment.len < segment_bytes(h.num_rings as usize, h.ring_bytes as usize)
+        {
+            return -1;
+        }
+        (h.num_rings as usize, h.exporter_pid)
+    };
+    let first = REMOTE_COUNT.load(Ordering::Acquire);
+    if first + num_rings > MAX_REMOTES {
+        return -1;
+    }
+
+    // Every ring is checked before any remote is built, so a bad one leaves
+    // nothing pointing into the segment once it is unmapped
+    let rings_ok = (0..num_rings).all(|i| {
+        let ring = ring_at(header, i) as *const InteropRing;
+        let slot_size = unsafe { (*ring).slot_size() };
+        slot_size == std::mem::size_of::<RingSlot>() as u32
+    });
+    if !rings_ok {
+        return -1;
+    }
+
+    let mut handles = Vec::with_capacity(num_rings);
+    for i in 0..num_rings {
+        let ring = ring_at(header, i) as *const InteropRing;
+        let mut name = unsafe { (*header).names[i] };
+        name[NAME_LEN - 1] = 0;
+        let remote = Box::new(InteropRemote {
+            ring,
+            lock: AtomicU32::new(0),
+            closed: AtomicU32::new(0),
+            exporter_pid: pid,
+            name,
+        });
+        let handle = first + i;
+        REMOTES[handle].store(Box::into_raw(remote), Ordering::Release);
+        handles.push(handle as i32);
+    }
+    REMOTE_COUNT.store(first + num_rings, Ordering::Release);
+    // Senders may hold pointers into the mapping for the life of the process
+    std::mem::forget(segment);
+
+    for &handle in &handles {
+        if let Some(r) = remote(handle) {
+            actor_directory::add(r.name(), RUNTIME_REMOTE);
+        }
+    }
+    imports.push(Import { channel: channel.to_string(), remotes: handles });
+    num_rings as i32
+}
+
+fn close_export(export: Export) {
+    let header = export.segment.ptr as *mut ChannelHeader;
+    let num_rings = unsafe { (*header).num_rings } as usize;
+    for i in 0..num_rings {
+        // SAFETY: laid out by export(); the pumps drain then exit
+        unsafe { &*(ring_at(header, i) as *const InteropRing) }.close();
+    }
+    for pump in export.pumps {
+        let _ = pump.join();
+    }
+    // Segment drop unmaps and unlinks it
+}
+
+/// Close a channel. An exporter closes its rings, lets the pumps drain and
+/// removes the segment; an importer stops sending to the channel's actors.
+/// Returns 0, or -1 if this process neither exports nor imports it
+pub fn close(channel: &str) -> i32 {
+    let mut found = false;
+    let export = {
+        let mut exports = EXPORTS.lock().unwrap();
+        exports.iter().position(|e| e.channel == channel).map(|pos| exports.remove(pos))
+    };
+    if let Some(export) = export {
+        close_export(export);
+        found = true;
+    }
+    let mut imports = IMPORTS.lock().unwrap();
+    if let Some(pos) = imports.iter().position(|i| i.channel == channel) {
+        for &handle in &imports.remove(pos).remotes {
+            if let Some(r) = remote(handle) {
+                r.closed.store(1, Ordering::Relaxed);
+            }
+        }
+        found = true;
+    }
+    if found { 0 } else { -1 }
+}
+
+// ============================================================================
+// FFI - see IpcChannel.hpp
+// ============================================================================
+
+fn c_str<'a>(s: *const c_char) -> Option<&'a str> {
+    if s.is_null() {
+        return None;
+    }
+    unsafe { CStr::from_ptr(s) }.to_str().ok()
+}
+
+#[no_mangle]
+pub extern "C" fn interop_ipc_export(
+    channel: *const c_char,
+    actors: *const *const c_char,
+    n: usize,
+    capacity: u32,
+    wakeup: c_int,
+) -> c_int {
+    let channel = match c_str(channel) {
+        Some(c) => c,
+        None => return -1,
+    };
+    if actors.is_null() {
+        return -1;
+    }
+    let names: Option<Vec<&str>> = unsafe { std::slice::from_raw_parts(actors, n) }
+        .iter()
+        .map(|&a| c_str(a))
+        .collect();
+    names.map_or(-1, |names| export(channel, &names, capacity, wakeup))
+}
+
+#[no_mangle]
+pub extern "C" fn interop_ipc_import(channel: *const c_char) -> c_int {
+    c_str(channel).map_or(-1, import)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_ipc_close(channel: *const c_char) -> c_int {
+    c_str(channel).map_or(-1, close)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_ipc_resolve(name: *const c_char) -> c_int {
+    c_str(name).map_or(-1, resolve)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_ipc_remote(handle: c_int) -> *const InteropRemote {
+    remote(handle).map_or(ptr::null(), |r| r as *const InteropRemote)
+}
+
+// ============================================================================
+// POSIX shared memory
+// ============================================================================
+
+#[cfg(target_os = "linux")]
+mod sys {
+    use std::ffi::CString;
+    use std::os::raw::{c_char, c_int, c_void};
+
+    const O_RDWR: c_int = 0o2;
+    const O_CREAT: c_int = 0o100;
+    const O_EXCL: c_int = 0o200;
+    const PROT_READ: c_int = 1;
+    const PROT_WRITE: c_int = 2;
+    const MAP_SHARED: c_int = 1;
+    const SEEK_END: c_int = 2;
+    const EPERM: i32 = 1;
+
+    extern "C" {
+        fn shm_open(name: *const c_char, oflag: c_int, mode: u32) -> c_int;
+        fn shm_unlink(name: *const c_char) -> c_int;
+        fn ftruncate(fd: c_int, length: i64) -> c_int;
+        fn lseek(fd: c_int, offset: i64, whence: c_int) -> i64;
+        fn mmap(addr: *mut c_void, len: usize, prot: c_int, flags: c_int, fd: c_int, offset: i64) -> *mut c_void;
+        fn munmap(addr: *mut c_void, len: usize) -> c_int;
+        fn close(fd: c_int) -> c_int;
+        fn getpid() -> c_int;
+        fn kill(pid: c_int, sig: c_int) -> c_int;
+    }
+
+    pub fn pid() -> i32 {
+        unsafe { getpid() }
+    }
+
+    /// True unless the process is known to be gone
+    pub fn alive(pid: i32) -> bool {
+        (unsafe { kill(pid, 0) }) == 0 || std::io::Error::last_os_error().raw_os_error() == Some(EPERM)
+    }
+
+    /// A mapped segment; the exporter's copy unlinks it on drop
+    pub struct Segment {
+        pub ptr: *mut u8,
+        pub len: usize,
+        name: CString,
+        owner: bool,
+    }
+
+    // SAFETY: the mapping is plain shared memory, reached through atomics
+    unsafe impl Send for Segment {}
+
+    fn shm_name(channel: &str) -> Option<CString> {
+        if channel.is_empty() || channel.contains('/') {
+            return None;
+        }
+        CString::new(format!("/interop.{}", channel)).ok()
+    }
+
+    fn map(fd: c_int, len: usize) -> Option<*mut u8> {
+        let p = unsafe { mmap(std::ptr::null_mut(), len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+        unsafe { close(fd) };
+        (p as isize != -1).then_some(p as *mut u8)
+    }
+
+    impl Segment {
+        /// Create a zeroed segment. A segment left by a dead exporter is replaced.
+        pub fn create(channel: &str, len: usize) -> Option<Segment> {
+            let name = shm_name(channel)?;
+            let mut fd = unsafe { shm_open(name.as_ptr(), O_RDWR | O_CREAT | O_EXCL, 0o600) };
+            if fd < 0 {
+                let stale = Segment::open(channel).is_some_and(|s| !alive(s.exporter_pid()));
+                if !stale {
+                    return None;
+                }
+                unsafe { shm_unlink(name.as_ptr()) };
+                fd = unsafe { shm_open(name.as_ptr(), O_RDWR | O_CREAT | O_EXCL, 0o600) };
+                if fd < 0 {
+                    return None;
+                }
+            }
+            if unsafe { ftruncate(fd, len as i64) } != 0 {
+                unsafe { close(fd) };
+                unsafe { shm_unlink(name.as_ptr()) };
+                return None;
+            }
+            match map(fd, len) {
+                Some(ptr) => Some(Segment { ptr, len, name, owner: true }),
+                None => {
+                    unsafe { shm_unlink(name.as_ptr()) };
+                    None
+                }
+            }
+        }
+
+        /// Map an existing segment
+        pub fn open(channel: &str) -> Option<Segment> {
+            let name = shm_name(channel)?;
+            let fd = unsafe { shm_open(name.as_ptr(), O_RDWR, 0) };
+            if fd < 0 {
+                return None;
+            }
+            let len = unsafe { lseek(fd, 0, SEEK_END) };
+            if len <= 0 {
+                unsafe { close(fd) };
+                return None;
+            }
+            let ptr = map(fd, len as usize)?;
+            Some(Segment { ptr, len: len as usize, name, owner: false })
+        }
+
+        fn exporter_pid(&self) -> i32 {
+            if self.len < std::mem::size_of::<super::ChannelHeader>() {
+                return 0;
+            }
+            unsafe { (*(self.ptr as *const super::ChannelHeader)).exporter_pid }
+        }
+    }
+
+    impl Drop for Segment {
+        fn drop(&mut self) {
+            unsafe { munmap(self.ptr as *mut c_void, self.len) };
+            if self.owner {
+                unsafe { shm_unlink(self.name.as_ptr()) };
+            }
+        }
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+mod sys {
+    pub fn pid() -> i32 {
+        0
+    }
+
+    pub fn alive(_pid: i32) -> bool {
+        true
+    }
+
+    pub struct Segment {
+        pub ptr: *mut u8,
+        pub len: usize,
+    }
+
+    unsafe impl Send for Segment {}
+
+    impl Segment {
+        pub fn create(_channel: &str, _len: usize) -> Option<Segment> {
+            None
+        }
+
+        pub fn open(_channel: &str) -> Option<Segment> {
+            None
+        }
+    }
+}
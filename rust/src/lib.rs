@@ -1,10 +1,21 @@
 //! actors-interop - FFI interop layer between actors-cpp and actors-rust
 //!
 //! This crate provides:
+//! - `actor_directory` - Name -> (runtime, handle) table shared with C++
 //! - `interop_messages` - Message definitions matching the C header
+//! - `interop_pool` - Shared work-stealing pool for direct actors of both runtimes
 //! - `rust_actor_bridge` - extern "C" functions for C++ to call Rust actors
 //! - `cpp_actor_if` - CppActorIF for Rust to call C++ actors
+//! - `interop_ring` - SPSC ring transport for hot C++/Rust actor pairs
+//! - `ipc_channel` - Interop rings in shared memory, between processes
+//! - `interop_stats` - Optional bridge counters (`stats` feature)
+//! - `interop_symbols` - Symbol table shared with C++ (interop_symbol IDs)
+//! - `interop_trace` - Sampled cross-language latency tracing (`stats` feature)
+//! - `interop_wire` - Versioned binary encoding for out-of-process transports
 //! - `rust_manager_ffi` - FFI functions for C++ to manage Rust Manager
+//! - `thread_placement` - CPU affinity and priority for Rust actor threads
+//! - `topic_publisher` - Topic-indexed fan-out publisher
+//! - `traffic_capture` - Recording and replay of bridge traffic
 //!
 //! Uses Manager's actor registry instead of separate registries.
 
@@ -18,12 +29,45 @@ pub mod rust_actor_bridge;
 #[path = "../../generated/rust/cpp_actor_if.rs"]
 pub mod cpp_actor_if;
 
+#[path = "../../generated/rust/interop_ring.rs"]
+pub mod interop_ring;
+
+#[path = "../../generated/rust/interop_stats.rs"]
+pub mod interop_stats;
+
+#[path = "../../generated/rust/interop_symbols.rs"]
+pub mod interop_symbols;
+
+#[path = "../../generated/rust/interop_trace.rs"]
+pub mod interop_trace;
+
+#[path = "../../generated/rust/interop_wire.rs"]
+pub mod interop_wire;
+
 // FFI for Rust Manager management
 pub mod rust_manager_ffi;
 
+// Topic-indexed pub/sub (Rust side of TopicPublisher.hpp)
+pub mod topic_publisher;
+
+// Thread placement for actors registered from C++ (see ThreadPlacement.hpp)
+pub mod thread_placement;
+
+// Cross-language actor directory, built after init (see ActorDirectory.hpp)
+pub mod actor_directory;
+
+// Out-of-process transport over shared-memory rings (see IpcChannel.hpp)
+pub mod ipc_channel;
+
+// Capture and replay of cross-language sends (see TrafficCapture.hpp)
+pub mod traffic_capture;
+
+// Shared worker pool for direct actors of both runtimes (see InteropPool.hpp)
+pub mod interop_pool;
+
 // Re-export commonly used items
 pub use interop_messages::*;
-pub use cpp_actor_if::{CppActorIF, InteropMessage};
+pub use cpp_actor_if::{CppActorIF, CppOwned, InteropMessage};
 
 // Example actors - included in the library so they can be called from C++
 #[path = "../../examples/ping_pong/rust_pong.rs"]
@@ -37,3 +81,8 @@ pub mod rust_ping;
 
 #[path = "../../examples/rust_subscribes_cpp_publisher/rust_subscriber.rs"]
 pub mod rust_subscriber;
+
+// Benchmark actors - driven by the C++ harness in bench/ (--features bench)
+#[cfg(feature = "bench")]
+#[path = "../../bench/rust_bench.rs"]
+pub mod bench;
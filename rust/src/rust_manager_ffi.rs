@@ -2,27 +2,39 @@
 //!
 //! Provides extern "C" functions to:
 //! - Create a Rust Manager
-//! - Register actors with the Manager
+//! - Register actors with the Manager by factory ID, one or many per call,
+//!   each with an optional thread placement - or, for direct actor kinds,
+//!   as direct actors (see DirectActor)
 //! - Initialize and run the Manager
-//! - Shutdown
-//! - Register C++ actor lookup for cross-language transparency
+//! - Shutdown (rust_manager_terminate() lets InteropShutdown.hpp stop it)
+//! - Register C++ actor lookup for cross-language transparency, answered
+//!   by the actor directory once it is built
 
-use std::ffi::CString;
-use std::sync::Mutex;
-use actors::{register_cpp_lookup, ActorRef, CppActorRef, Manager, ThreadConfig};
+use std::cell::{Cell, RefCell};
+use std::collections::HashSet;
+use std::ffi::{CStr, CString};
+use std::sync::atomic::{AtomicPtr, Ordering};
+use std::sync::{Mutex, MutexGuard};
+use actors::{register_cpp_lookup, Actor, ActorRef, CppActorRef, Manager, ManagerHandle, ThreadConfig};
+use crate::actor_directory::{self, Lookup, RUNTIME_CPP, RUNTIME_RUST};
+use crate::interop_stats as stats;
+use crate::ipc_channel;
+use crate::rust_actor_bridge::{register_direct_actor, DirectActor};
+use crate::thread_placement::{InteropThreadConfig, Placed, Placement};
 use crate::ping_pong::RustPongActor;
 use crate::rust_ping::RustPingActor;
 use crate::pubsub::RustPublisher;
 use crate::rust_subscriber::RustSubscriber;
 
-// Wrapper to make Manager pointer safe for static storage
-struct ManagerPtr(*mut Manager);
-unsafe impl Send for ManagerPtr {}
-unsafe impl Sync for ManagerPtr {}
+// Global Manager - created and owned by this module, never freed.
+// Published through an atomic so get_actor_ref() never locks; the
+// lifecycle functions below are serialized by MANAGER_LOCK instead.
+static RUST_MANAGER: AtomicPtr<Manager> = AtomicPtr::new(std::ptr::null_mut());
+static MANAGER_LOCK: Mutex<()> = Mutex::new(());
 
-// Global Manager - created and owned by this module
-// Use Mutex with a pointer wrapper since Manager doesn't impl Sync
-static RUST_MANAGER: Mutex<ManagerPtr> = Mutex::new(ManagerPtr(std::ptr::null_mut()));
+// Lets rust_manager_terminate() stop the Manager while rust_manager_end()
+// holds MANAGER_LOCK waiting for it
+static MANAGER_HANDLE: Mutex<Option<ManagerHandle>> = Mutex::new(None);
 
 /// Create the Rust Manager
 /// Call this once at startup before registering actors
@@ -30,48 +42,16 @@ static RUST_MANAGER: Mutex<ManagerPtr> = Mutex::new(ManagerPtr(std::ptr::null_mu
 pub extern "C" fn create_rust_manager() {
     let mgr = Box::new(Manager::new());
     let ptr = Box::into_raw(mgr);
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    guard.0 = ptr;
-}
-
-/// Register the RustPingActor with the Rust Manager
-/// Returns the Manager pointer for rust_actor_init()
-#[no_mangle]
-pub extern "C" fn register_rust_ping_actor() -> *const Manager {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
-        let handle = mgr.get_handle();
-        let actor = RustPingActor::new(handle);
-        mgr.manage("rust_ping", Box::new(actor), ThreadConfig::default());
-        guard.0 as *const Manager
-    } else {
-        std::ptr::null()
-    }
-}
-
-/// Register the RustPongActor with the Rust Manager
-/// Returns the Manager pointer for rust_actor_init()
-#[no_mangle]
-pub extern "C" fn register_rust_pong_actor() -> *const Manager {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
-        let handle = mgr.get_handle();
-        let actor = RustPongActor::new(handle);
-        mgr.manage("rust_pong", Box::new(actor), ThreadConfig::default());
-        guard.0 as *const Manager
-    } else {
-        std::ptr::null()
-    }
+    let _lock = MANAGER_LOCK.lock().unwrap();
+    *MANAGER_HANDLE.lock().unwrap() = Some(unsafe { &mut *ptr }.get_handle());
+    RUST_MANAGER.store(ptr, Ordering::Release);
 }
 
 /// Get pointer to the Rust Manager
 /// For passing to rust_actor_init()
 #[no_mangle]
 pub extern "C" fn get_rust_manager() -> *const Manager {
-    let guard = RUST_MANAGER.lock().unwrap();
-    guard.0 as *const Manager
+    RUST_MANAGER.load(Ordering::Acquire) as *const Manager
 }
 
 /// Get an ActorRef by name from the global Manager.
@@ -86,9 +66,10 @@ pub extern "C" fn get_rust_manager() -> *const Manager {
 /// # Returns
 /// Some(ActorRef) if found, None otherwise
 pub fn get_actor_ref(name: &str, sender: &str) -> Option<ActorRef> {
-    let guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &*guard.0 };
+    let ptr = RUST_MANAGER.load(Ordering::Acquire);
+    if !ptr.is_null() {
+        // SAFETY: the Manager is never freed once published
+        let mgr = unsafe { &*ptr };
         mgr.get_ref_with_sender(name, sender)
     } else {
         None
@@ -99,129 +80,392 @@ pub fn get_actor_ref(name: &str, sender: &str) -> Option<ActorRef> {
 /// This sends Start message to all actors
 #[no_mangle]
 pub extern "C" fn rust_manager_init() {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
+    let _lock = MANAGER_LOCK.lock().unwrap();
+    let ptr = RUST_MANAGER.load(Ordering::Acquire);
+    if !ptr.is_null() {
+        let mgr = unsafe { &mut *ptr };
         mgr.init();
     }
 }
 
 /// Shutdown all Rust actors and wait for threads to finish
+/// Returns once the Manager is terminated - by an actor, or by
+/// rust_manager_terminate()
 #[no_mangle]
 pub extern "C" fn rust_manager_end() {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
+    let _lock = MANAGER_LOCK.lock().unwrap();
+    let ptr = RUST_MANAGER.load(Ordering::Acquire);
+    if !ptr.is_null() {
+        let mgr = unsafe { &mut *ptr };
         mgr.end();
     }
 }
 
-/// Register the RustPublisher with the Rust Manager
-/// Returns the Manager pointer for rust_actor_init()
+/// Terminate the Rust Manager, so that rust_manager_end() returns
+/// Takes no Manager lock - safe while another thread is in rust_manager_end()
 #[no_mangle]
-pub extern "C" fn register_rust_publisher() -> *const Manager {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
-        let handle = mgr.get_handle();
-        let actor = RustPublisher::new(handle);
-        mgr.manage("rust_publisher", Box::new(actor), ThreadConfig::default());
-        guard.0 as *const Manager
-    } else {
-        std::ptr::null()
+pub extern "C" fn rust_manager_terminate() {
+    if let Some(handle) = MANAGER_HANDLE.lock().unwrap().as_ref() {
+        handle.terminate();
     }
 }
 
-/// Register the RustSubscriber with the Rust Manager
-/// Returns the Manager pointer for rust_actor_init()
+// ============================================================================
+// Actor registration - table-driven, by factory ID
+// ============================================================================
+
+/// Builds one actor; the handle lets it reach its Manager
+pub type ActorFactory = fn(ManagerHandle) -> Box<dyn Actor>;
+
+/// Builds one direct actor - it runs on its senders' threads, outside the
+/// Manager (see DirectActor)
+pub type DirectFactory = fn() -> Box<dyn DirectActor>;
+
+/// What a factory ID builds
+#[derive(Clone, Copy)]
+pub enum Factory {
+    Actor(ActorFactory),
+    Direct(DirectFactory),
+}
+
+// Kinds every build can create, with fixed IDs 0..
+const BUILTIN_FACTORIES: [(&str, Factory); 4] = [
+    ("RustPingActor", Factory::Actor(|h| Box::new(RustPingActor::new(h)))),
+    ("RustPongActor", Factory::Actor(|h| Box::new(RustPongActor::new(h)))),
+    ("RustPublisher", Factory::Actor(|h| Box::new(RustPublisher::new(h)))),
+    ("RustSubscriber", Factory::Actor(|h| Box::new(RustSubscriber::new(h)))),
+];
+
+// Actor kinds C++ can create; the factory ID is the index
+static FACTORIES: Mutex<Vec<(&'static str, Factory)>> = Mutex::new(Vec::new());
+
+fn factories() -> MutexGuard<'static, Vec<(&'static str, Factory)>> {
+    let mut factories = FACTORIES.lock().unwrap();
+    if factories.is_empty() {
+        factories.extend_from_slice(&BUILTIN_FACTORIES);
+        #[cfg(feature = "bench")]
+        factories.extend_from_slice(&crate::bench::FACTORIES);
+    }
+    factories
+}
+
+fn add_factory(kind: &'static str, factory: Factory) -> i32 {
+    let mut factories = factories();
+    if factories.iter().any(|(k, _)| *k == kind) {
+        return -1;
+    }
+    factories.push((kind, factory));
+    (factories.len() - 1) as i32
+}
+
+/// Add an actor kind that C++ can create by factory ID
+/// Returns its ID, or -1 if the kind is already registered
+pub fn register_actor_factory(kind: &'static str, factory: ActorFactory) -> i32 {
+    add_factory(kind, Factory::Actor(factory))
+}
+
+/// Add a direct actor kind that C++ can create by factory ID - specs of
+/// this kind are registered as direct actors, not given to the Manager
+/// Returns its ID, or -1 if the kind is already registered
+pub fn register_direct_factory(kind: &'static str, factory: DirectFactory) -> i32 {
+    add_factory(kind, Factory::Direct(factory))
+}
+
+/// Factory ID for an actor kind (its type name, e.g. "RustPongActor")
+/// Returns the ID >= 0, or -1 if the kind is unknown
 #[no_mangle]
-pub extern "C" fn register_rust_subscriber() -> *const Manager {
-    let mut guard = RUST_MANAGER.lock().unwrap();
-    if !guard.0.is_null() {
-        let mgr = unsafe { &mut *guard.0 };
-        let handle = mgr.get_handle();
-        let actor = RustSubscriber::new(handle);
-        mgr.manage("rust_price_monitor", Box::new(actor), ThreadConfig::default());
-        guard.0 as *const Manager
+pub extern "C" fn rust_actor_factory(kind: *const c_char) -> c_int {
+    if kind.is_null() {
+        return -1;
+    }
+    let kind = unsafe { CStr::from_ptr(kind) }.to_bytes();
+    factories()
+        .iter()
+        .position(|(k, _)| k.as_bytes() == kind)
+        .map_or(-1, |i| i as c_int)
+}
+
+/// One actor for register_rust_actors() (same layout as RustActorRegistry.hpp)
+#[repr(C)]
+pub struct InteropActorSpec {
+    pub name: *const c_char,
+    pub factory_id: c_int,
+    /// Thread placement, null = Manager default
+    pub config: *const InteropThreadConfig,
+}
+
+/// A checked spec, ready to build
+struct Spec<'a> {
+    name: &'a str,
+    factory: Factory,
+    placement: Placement,
+}
+
+/// None if the name is null or not UTF-8, the factory is unknown or the
+/// config is invalid (a direct actor runs on its senders' threads, so it
+/// takes no config)
+unsafe fn check_spec<'a>(spec: &'a InteropActorSpec, factories: &[(&str, Factory)]) -> Option<Spec<'a>> {
+    if spec.name.is_null() {
+        return None;
+    }
+    let name = CStr::from_ptr(spec.name).to_str().ok()?;
+    let factory = usize::try_from(spec.factory_id).ok().and_then(|i| factories.get(i))?.1;
+    let placement = if spec.config.is_null() {
+        Placement::default()
+    } else if let Factory::Direct(_) = factory {
+        return None;
     } else {
-        std::ptr::null()
+        Placement::from_c(&*spec.config)?
+    };
+    Some(Spec { name, factory, placement })
+}
+
+/// Build and register every spec under one lock - none if a name is taken.
+/// False if a direct actor could not be registered (its table is full).
+fn manage_all(specs: &[Spec]) -> bool {
+    let _lock = MANAGER_LOCK.lock().unwrap();
+    let ptr = RUST_MANAGER.load(Ordering::Acquire);
+    if ptr.is_null() {
+        return false;
+    }
+    let mgr = unsafe { &mut *ptr };
+    let taken = |name: &str| mgr.get_ref(name).is_some() || crate::rust_actor_bridge::direct_resolve(name).is_some();
+    if specs.iter().any(|s| taken(s.name)) {
+        return false;
+    }
+    let mut ok = true;
+    for spec in specs {
+        match spec.factory {
+            Factory::Actor(factory) => {
+                let actor = factory(mgr.get_handle());
+                let actor: Box<dyn Actor> = if spec.placement.is_default() {
+                    actor
+                } else {
+                    Box::new(Placed::new(actor, spec.placement.clone()))
+                };
+                mgr.manage(spec.name, actor, ThreadConfig::default());
+            }
+            // Added to the actor directory by the bridge
+            Factory::Direct(factory) => ok &= register_direct_actor(spec.name, factory()) >= 0,
+        }
+    }
+    ok
+}
+
+/// Register `n` Rust actors in one pass. Every spec is checked first, then
+/// all are built and managed under a single lock; nothing is registered if
+/// any spec is invalid or a name repeats or is taken. Each thread is placed
+/// per its spec's config before the actor handles Start. Specs of a direct
+/// kind (register_direct_factory()) become direct actors instead. The
+/// actors are added to the actor directory.
+///
+/// If `handles` is non-null it receives each actor's bridge handle for
+/// rust_actor_send_h(). Resolving them initializes the bridge with this
+/// Manager, as rust_actor_init() does.
+///
+/// Returns the Manager pointer for rust_actor_init(), or null on failure -
+/// including a full direct actor table, found only once the other specs
+/// are registered
+#[no_mangle]
+pub extern "C" fn register_rust_actors(
+    specs: *const InteropActorSpec,
+    n: usize,
+    handles: *mut c_int,
+) -> *const Manager {
+    if specs.is_null() && n > 0 {
+        return std::ptr::null();
+    }
+    let specs = if n == 0 { &[][..] } else { unsafe { std::slice::from_raw_parts(specs, n) } };
+    let checked: Option<Vec<Spec>> = {
+        let factories = factories();
+        specs.iter().map(|s| unsafe { check_spec(s, &factories) }).collect()
+    };
+    let checked = match checked {
+        Some(c) => c,
+        None => return std::ptr::null(),
+    };
+    let mut names = HashSet::with_capacity(n);
+    if !checked.iter().all(|s| names.insert(s.name)) {
+        return std::ptr::null();
+    }
+
+    if !manage_all(&checked) {
+        return std::ptr::null();
+    }
+    for spec in checked.iter().filter(|s| matches!(s.factory, Factory::Actor(_))) {
+        actor_directory::add(spec.name, RUNTIME_RUST);
     }
+    let ptr = get_rust_manager();
+    if !handles.is_null() {
+        crate::rust_actor_bridge::rust_actor_init(ptr);
+        let handles = unsafe { std::slice::from_raw_parts_mut(handles, n) };
+        for (handle, spec) in handles.iter_mut().zip(&checked) {
+            *handle = crate::rust_actor_bridge::resolve(spec.name);
+        }
+    }
+    ptr
+}
+
+/// Register one Rust actor - register_rust_actors() with a single spec
+#[no_mangle]
+pub extern "C" fn register_rust_actor(
+    name: *const c_char,
+    factory_id: c_int,
+    config: *const InteropThreadConfig,
+) -> *const Manager {
+    let spec = InteropActorSpec { name, factory_id, config };
+    register_rust_actors(&spec, 1, std::ptr::null_mut())
 }
 
 // ============================================================================
 // C++ Actor Lookup Integration
 // ============================================================================
 
-use std::os::raw::{c_char, c_int, c_void};
+use std::os::raw::{c_char, c_int};
 
-// FFI functions to send to C++ actors
 extern "C" {
-    fn cpp_actor_send(
-        actor_name: *const c_char,
-        sender_name: *const c_char,
-        msg_type: c_int,
-        msg_data: *const c_void,
-    ) -> c_int;
+    fn cpp_actor_resolve(name: *const c_char) -> c_int;
+}
 
-    fn cpp_actor_exists(name: *const c_char) -> c_int;
+// CppActorRef is defined in actors-rust, so resolved handles are cached here
+// per thread, keyed by the address of the name's bytes (see HandleCache).
+thread_local! {
+    static CPP_HANDLES: RefCell<HandleCache> = RefCell::new(HandleCache::new());
+    static RUST_HANDLES: RefCell<HandleCache> = RefCell::new(HandleCache::new());
+    static REMOTE_HANDLES: RefCell<HandleCache> = RefCell::new(HandleCache::new());
+    static LAST_SEND_STATUS: Cell<i32> = const { Cell::new(0) };
 }
 
-/// The send function that will be passed to CppActorRef.
-/// This dispatches by message_id, downcasts to concrete type, converts to C struct,
-/// and calls the FFI function. Actors just call send() - they don't know about FFI.
-fn cpp_send_fn(target: &str, sender: &str, msg: &dyn actors::Message) -> i32 {
-    use crate::interop_messages::*;
+const HANDLE_CACHE_SLOTS: usize = 64;
 
-    let target_cstr = CString::new(target).unwrap();
-    let sender_cstr = if sender.is_empty() {
-        None
-    } else {
-        Some(CString::new(sender).unwrap())
-    };
-    let sender_ptr = sender_cstr.as_ref().map_or(std::ptr::null(), |s| s.as_ptr());
+#[derive(Default)]
+struct HandleCacheEntry {
+    key: usize,
+    epoch: u32,
+    handle: i32,
+    name: String,
+}
+
+/// A thread's resolved handles, direct-mapped by the address of the name's
+/// bytes (a CppActorRef's String). A hit is a pointer compare plus a memcmp
+/// against the name copied at resolve time - no hashing, no allocation - so
+/// storage freed and reused for another name misses. Entries from an earlier
+/// handle epoch (before a bridge shutdown) miss too.
+struct HandleCache {
+    slots: Box<[HandleCacheEntry]>,
+}
 
-    let msg_id = msg.message_id();
+impl HandleCache {
+    fn new() -> Self {
+        HandleCache { slots: (0..HANDLE_CACHE_SLOTS).map(|_| HandleCacheEntry::default()).collect() }
+    }
 
-    // Dispatch by message ID, downcast, convert to C struct, call FFI
-    match msg_id {
-        MSG_PING => {
-            if let Some(m) = msg.as_any().downcast_ref::<Ping>() {
-                let c_msg = m.to_c_struct();
-                unsafe { cpp_actor_send(target_cstr.as_ptr(), sender_ptr, msg_id, &c_msg as *const _ as *const c_void) }
-            } else { -3 }
-        }
-        MSG_PONG => {
-            if let Some(m) = msg.as_any().downcast_ref::<Pong>() {
-                let c_msg = m.to_c_struct();
-                unsafe { cpp_actor_send(target_cstr.as_ptr(), sender_ptr, msg_id, &c_msg as *const _ as *const c_void) }
-            } else { -3 }
+    fn get(&mut self, name: &str, resolve: fn(&str) -> i32) -> i32 {
+        let key = name.as_ptr() as usize;
+        let epoch = crate::rust_actor_bridge::handle_epoch();
+        let entry = &mut self.slots[((key >> 3) ^ (key >> 9)) & (HANDLE_CACHE_SLOTS - 1)];
+        if entry.key == key && entry.epoch == epoch && entry.name == name {
+            return entry.handle;
         }
-        MSG_SUBSCRIBE => {
-            if let Some(m) = msg.as_any().downcast_ref::<Subscribe>() {
-                let c_msg = m.to_c_struct();
-                unsafe { cpp_actor_send(target_cstr.as_ptr(), sender_ptr, msg_id, &c_msg as *const _ as *const c_void) }
-            } else { -3 }
+        let handle = resolve(name);
+        if handle >= 0 {
+            entry.key = key;
+            entry.epoch = epoch;
+            entry.handle = handle;
+            entry.name.clear();
+            entry.name.push_str(name);
         }
-        MSG_MARKETUPDATE => {
-            if let Some(m) = msg.as_any().downcast_ref::<MarketUpdate>() {
-                let c_msg = m.to_c_struct();
-                unsafe { cpp_actor_send(target_cstr.as_ptr(), sender_ptr, msg_id, &c_msg as *const _ as *const c_void) }
-            } else { -3 }
-        }
-        _ => -2  // Unknown message type
+        handle
     }
 }
 
-/// Lookup function for C++ actors
-/// Returns Some(ActorRef::Cpp) if the actor exists in C++
-fn cpp_actor_lookup(name: &str, sender: &str) -> Option<ActorRef> {
-    let name_cstr = CString::new(name).unwrap();
-    unsafe {
-        if cpp_actor_exists(name_cstr.as_ptr()) != 0 {
-            Some(ActorRef::Cpp(CppActorRef::new(name, sender, cpp_send_fn)))
+/// Result of the calling thread's last send to a C++ actor: 0, or a bridge
+/// code such as -5 (the actor's mailbox is full). ActorRef::send() returns
+/// nothing, so this is where a Rust sender sees backpressure.
+pub fn last_send_status() -> i32 {
+    LAST_SEND_STATUS.with(|s| s.get())
+}
+
+/// Look up a handle in the calling thread's cache, resolving on a miss.
+/// Only successful resolutions are cached.
+fn cached_handle(
+    cache: &'static std::thread::LocalKey<RefCell<HandleCache>>,
+    name: &str,
+    resolve: fn(&str) -> i32,
+) -> i32 {
+    // try_borrow_mut: a resolve that re-enters this cache just resolves uncached
+    cache.with(|c| match c.try_borrow_mut() {
+        Ok(mut c) => c.get(name, resolve),
+        Err(_) => resolve(name),
+    })
+}
+
+/// Bridge handle of a C++ actor, cached per thread (-1 if not found)
+pub fn cpp_handle(name: &str) -> i32 {
+    cached_handle(&CPP_HANDLES, name, find_cpp)
+}
+
+/// A built directory answers without crossing the FFI; before that, ask C++
+fn find_cpp(name: &str) -> i32 {
+    match actor_directory::lookup(name) {
+        Lookup::Found(location) if location.runtime == RUNTIME_CPP => location.handle,
+        Lookup::Found(_) | Lookup::Missing => -1,
+        Lookup::NotBuilt => resolve_cpp(name),
+    }
+}
+
+/// Resolve a C++ actor through the bridge (one FFI call, no caching)
+pub(crate) fn resolve_cpp(name: &str) -> i32 {
+    match CString::new(name) {
+        Ok(c) => unsafe { cpp_actor_resolve(c.as_ptr()) },
+        Err(_) => -1,
+    }
+}
+
+/// The send function that will be passed to CppActorRef.
+/// This resolves both handles, then the generated table in cpp_actor_if
+/// picks the message type by ID, converts it to a C struct and calls the
+/// FFI function. Actors just call send() - they don't know about FFI.
+///
+/// Once both handles are cached this does no allocation; see benches/send_alloc.rs.
+pub fn cpp_send_fn(target: &str, sender: &str, msg: &dyn actors::Message) -> i32 {
+    let handle = cpp_handle(target);
+    let rc = if handle < 0 {
+        -1  // Actor not found
+    } else {
+        let sender_handle = if sender.is_empty() {
+            -1
         } else {
-            None
-        }
+            cached_handle(&RUST_HANDLES, sender, crate::rust_actor_bridge::resolve)
+        };
+        crate::cpp_actor_if::send_to_cpp(handle, sender_handle, msg)
+    };
+    LAST_SEND_STATUS.with(|s| s.set(rc));
+    stats::status(stats::CPP_SEND_FN, rc)
+}
+
+/// The send function for actors imported from another process: pushes the
+/// C struct into the actor's IPC ring (see ipc_channel).
+/// Returns 0, -1 if the actor is unknown or its channel closed, -2 for a
+/// type that cannot be queued
+pub fn ipc_send_fn(target: &str, _sender: &str, msg: &dyn actors::Message) -> i32 {
+    let handle = cached_handle(&REMOTE_HANDLES, target, ipc_channel::resolve);
+    match ipc_channel::remote(handle) {
+        Some(remote) => remote.send(msg),
+        None => -1,
+    }
+}
+
+/// Lookup function for C++ actors, and for actors in other processes
+/// Returns Some(ActorRef::Cpp) if the actor exists in C++ or is imported.
+/// Resolving also caches the handle for the calling thread.
+fn cpp_actor_lookup(name: &str, sender: &str) -> Option<ActorRef> {
+    if cpp_handle(name) >= 0 {
+        Some(ActorRef::Cpp(CppActorRef::new(name, sender, cpp_send_fn)))
+    } else if ipc_channel::resolve(name) >= 0 {
+        Some(ActorRef::Cpp(CppActorRef::new(name, sender, ipc_send_fn)))
+    } else {
+        None
     }
 }
 
@@ -0,0 +1,177 @@
+//! Thread placement for Rust actors - CPU affinity and real-time priority
+//!
+//! actors-rust spawns each actor's thread itself, so `Placed` applies the
+//! placement from inside that thread, just before the actor handles its
+//! first message (Start). C++ registers placed actors through
+//! register_rust_actor() with an `InteropThreadConfig` (ThreadPlacement.hpp).
+//!
+//! Placement is a hint: if the OS refuses it the thread runs unplaced, and
+//! the failure is counted for interop_placement_failures().
+
+use std::os::raw::c_int;
+use std::sync::atomic::{AtomicI32, AtomicU32, Ordering};
+
+use actors::{Actor, ActorContext, Message};
+
+/// Thread placement as passed from C++ (same layout as ThreadPlacement.hpp)
+#[repr(C)]
+pub struct InteropThreadConfig {
+    /// CPUs the actor's thread may run on (null or num_cpus = 0: any)
+    pub cpus: *const c_int,
+    /// 1 = pinned to that CPU
+    pub num_cpus: c_int,
+    /// SCHED_FIFO priority 1-99, 0 = leave the OS default
+    pub priority: c_int,
+}
+
+/// Largest CPU index a placement can name (cpu_set_t holds 1024)
+pub const MAX_CPUS: usize = 1024;
+
+/// Where an actor's thread runs
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct Placement {
+    pub cpus: Vec<usize>,
+    pub priority: i32,
+}
+
+impl Placement {
+    /// Copy a C config (None if it names a negative or out-of-range CPU)
+    ///
+    /// # Safety
+    /// `cfg.cpus` must point to `cfg.num_cpus` ints, or be null.
+    pub unsafe fn from_c(cfg: &InteropThreadConfig) -> Option<Self> {
+        let cpus = if cfg.cpus.is_null() || cfg.num_cpus <= 0 {
+            &[][..]
+        } else {
+            std::slice::from_raw_parts(cfg.cpus, cfg.num_cpus as usize)
+        };
+        if cpus.iter().any(|&c| c < 0 || c as usize >= MAX_CPUS) || !(0..=99).contains(&cfg.priority) {
+            return None;
+        }
+        Some(Placement {
+            cpus: cpus.iter().map(|&c| c as usize).collect(),
+            priority: cfg.priority,
+        })
+    }
+
+    /// True if this leaves the thread exactly as the Manager started it
+    pub fn is_default(&self) -> bool {
+        self.cpus.is_empty() && self.priority == 0
+    }
+
+    /// Apply to the calling thread. Returns the first OS error code.
+    pub fn apply_to_current_thread(&self) -> Result<(), i32> {
+        if !self.cpus.is_empty() {
+            sys::set_affinity(&self.cpus)?;
+        }
+        if self.priority > 0 {
+            sys::set_fifo_priority(self.priority)?;
+        }
+        Ok(())
+    }
+
+    /// Apply to the calling thread, recording a failure instead of
+    /// returning it (for threads with no caller to report to)
+    pub fn apply_or_record(&self) {
+        if let Err(err) = self.apply_to_current_thread() {
+            LAST_ERROR.store(err, Ordering::Relaxed);
+            FAILURES.fetch_add(1, Ordering::Release);
+        }
+    }
+}
+
+static FAILURES: AtomicU32 = AtomicU32::new(0);
+static LAST_ERROR: AtomicI32 = AtomicI32::new(0);
+
+/// Number of placements the OS refused (placed actors and pool workers).
+/// If last_errno is non-null it receives the latest failure's OS error code
+/// (0 if none).
+#[no_mangle]
+pub extern "C" fn interop_placement_failures(last_errno: *mut c_int) -> u32 {
+    let failures = FAILURES.load(Ordering::Acquire);
+    if !last_errno.is_null() {
+        unsafe { *last_errno = LAST_ERROR.load(Ordering::Relaxed) };
+    }
+    failures
+}
+
+/// An actor whose thread is placed before it handles its first message.
+/// It stands in for the actor in the Manager, so it forwards every `Actor`
+/// method; process_message() is the only one the trait has, and a method
+/// added to the trait must be forwarded here too.
+pub struct Placed {
+    inner: Box<dyn Actor>,
+    placement: Option<Placement>,
+}
+
+impl Placed {
+    pub fn new(inner: Box<dyn Actor>, placement: Placement) -> Self {
+        Placed { inner, placement: Some(placement) }
+    }
+}
+
+impl Actor for Placed {
+    fn process_message(&mut self, msg: &dyn Message, ctx: &mut ActorContext) {
+        if let Some(placement) = self.placement.take() {
+            placement.apply_or_record();
+        }
+        self.inner.process_message(msg, ctx);
+    }
+}
+
+#[cfg(target_os = "linux")]
+mod sys {
+    use std::os::raw::{c_int, c_ulong};
+
+    use super::MAX_CPUS;
+
+    #[repr(C)]
+    struct SchedParam {
+        sched_priority: c_int,
+    }
+
+    const SCHED_FIFO: c_int = 1;
+
+    extern "C" {
+        fn sched_setaffinity(pid: c_int, cpusetsize: usize, mask: *const u64) -> c_int;
+        fn pthread_self() -> c_ulong;
+        fn pthread_setschedparam(thread: c_ulong, policy: c_int, param: *const SchedParam) -> c_int;
+    }
+
+    fn errno() -> i32 {
+        std::io::Error::last_os_error().raw_os_error().unwrap_or(-1)
+    }
+
+    pub fn set_affinity(cpus: &[usize]) -> Result<(), i32> {
+        let mut mask = [0u64; MAX_CPUS / 64];
+        for &cpu in cpus {
+            mask[cpu / 64] |= 1 << (cpu % 64);
+        }
+        // pid 0 = the calling thread
+        match unsafe { sched_setaffinity(0, std::mem::size_of_val(&mask), mask.as_ptr()) } {
+            0 => Ok(()),
+            _ => Err(errno()),
+        }
+    }
+
+    pub fn set_fifo_priority(priority: i32) -> Result<(), i32> {
+        let param = SchedParam { sched_priority: priority };
+        match unsafe { pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) } {
+            0 => Ok(()),
+            err => Err(err),
+        }
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+mod sys {
+    const ENOSYS: i32 = 38;
+
+    pub fn set_affinity(_cpus: &[usize]) -> Result<(), i32> {
+        Err(ENOSYS)
+    }
+
+    pub fn set_fifo_priority(_priority: i32) -> Result<(), i32> {
+        Err(ENOSYS)
+    }
+}
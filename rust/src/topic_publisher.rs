@@ -0,0 +1,149 @@
+//! TopicPublisher - topic-indexed fan-out for one plain-data message type
+//!
+//! Rust counterpart of generated/cpp/TopicPublisher.hpp. Topics are
+//! interop_symbol IDs from the shared symbol table (interop_symbols), so the
+//! topic of a Subscribe indexes the subscriber lists directly. Each topic
+//! keeps its own lists and a tick touches only the subscribers of the topics
+//! it publishes.
+//!
+//! Rust subscribers each get their own copy (every actor owns the Box it is
+//! sent). C++ subscribers are grouped: publish() appends the payload once per
+//! topic to a tick buffer and flush() hands the whole tick to
+//! cpp_actor_fanout() - one FFI call per tick, not per subscriber.
+//!
+//! Usage (as a field of the publishing actor):
+//!   let mut feed = TopicPublisher::<MarketUpdate>::new("rust_publisher");
+//!   feed.subscribe(msg.topic, "cpp_subscriber", &subscriber_ref);
+//!   feed.publish(msg.topic, &update);
+//!   feed.flush();  // every C++ subscriber, one FFI call
+
+use actors::{ActorRef, Message};
+use crate::cpp_actor_if::{fanout_to_cpp, InteropMessage};
+use crate::interop_symbols::{InteropSymbol, NO_SYMBOL};
+use crate::rust_actor_bridge;
+use crate::rust_manager_ffi::cpp_handle;
+
+pub type TopicId = InteropSymbol;
+pub const NO_TOPIC: TopicId = NO_SYMBOL;
+
+#[derive(Default)]
+struct Subscribers {
+    rust: Vec<(String, ActorRef)>,  // Rust actors, keyed by name
+    cpp: Vec<i32>,                  // C++ actor handles
+}
+
+/// Fan-out publisher for plain-data messages (the message is its own C struct)
+pub struct TopicPublisher<M: InteropMessage<CStruct = M>> {
+    owner: String,
+    owner_handle: i32,  // resolved on first flush()
+    subscribers: Vec<Subscribers>,  // indexed by TopicId, grown on subscribe
+
+    // Tick buffer: items[i] goes to cpp_handles[offsets[i] .. offsets[i + 1]]
+    items: Vec<M>,
+    offsets: Vec<i32>,
+    cpp_handles: Vec<i32>,
+}
+
+impl<M: InteropMessage<CStruct = M> + Message + Clone + 'static> TopicPublisher<M> {
+    /// owner is the publishing actor's name - the sender C++ replies go to
+    pub fn new(owner: &str) -> Self {
+        TopicPublisher {
+            owner: owner.to_string(),
+            owner_handle: -1,
+            subscribers: Vec::new(),
+            items: Vec::new(),
+            offsets: vec![0],
+            cpp_handles: Vec::new(),
+        }
+    }
+
+    /// Subscribe an actor; C++ actors are resolved to bridge handles by name
+    /// Returns false for NO_TOPIC, if already subscribed, or if the C++ actor
+    /// is not found
+    pub fn subscribe(&mut self, topic: TopicId, name: &str, subscriber: &ActorRef) -> bool {
+        if topic == NO_TOPIC {
+            return false;
+        }
+        if topic as usize >= self.subscribers.len() {
+            self.subscribers.resize_with(topic as usize + 1, Subscribers::default);
+        }
+        let s = &mut self.subscribers[topic as usize];
+        match subscriber {
+            ActorRef::Cpp(_) => {
+                let handle = cpp_handle(name);
+                if handle < 0 || s.cpp.contains(&handle) {
+                    return false;
+                }
+                s.cpp.push(handle);
+            }
+            _ => {
+                if s.rust.iter().any(|(n, _)| n == name) {
+                    return false;
+                }
+                s.rust.push((name.to_string(), subscriber.clone()));
+            }
+        }
+        true
+    }
+
+    /// Returns false if the actor was not subscribed
+    pub fn unsubscribe(&mut self, topic: TopicId, name: &str) -> bool {
+        let s = match self.subscribers.get_mut(topic as usize) {
+            Some(s) => s,
+            None => return false,
+        };
+        // Order is not kept - subscribers are a set
+        if let Some(i) = s.rust.iter().position(|(n, _)| n == name) {
+            s.rust.swap_remove(i);
+            return true;
+        }
+        let handle = cpp_handle(name);
+        match s.cpp.iter().position(|&h| h == handle) {
+            Some(i) => {
+                s.cpp.swap_remove(i);
+                true
+            }
+            None => false,
+        }
+    }
+
+    pub fn subscriber_count(&self, topic: TopicId) -> usize {
+        self.subscribers
+            .get(topic as usize)
+            .map_or(0, |s| s.rust.len() + s.cpp.len())
+    }
+
+    /// Send payload to every subscriber of topic: Rust subscribers now,
+    /// C++ subscribers at the next flush()
+    pub fn publish(&mut self, topic: TopicId, payload: &M) {
+        let s = match self.subscribers.get(topic as usize) {
+            Some(s) => s,
+            None => return,
+        };
+        for (_, r) in &s.rust {
+            r.send(Box::new(payload.clone()), None);
+        }
+        if !s.cpp.is_empty() {
+            self.items.push(payload.clone());
+            self.cpp_handles.extend_from_slice(&s.cpp);
+            self.offsets.push(self.cpp_handles.len() as i32);
+        }
+    }
+
+    /// Deliver everything published since the last flush() to C++ with one
+    /// FFI call. Returns the number of C++ deliveries or the bridge error.
+    /// The buffers keep their capacity, so steady-state ticks do not allocate.
+    pub fn flush(&mut self) -> i32 {
+        if self.items.is_empty() {
+            return 0;
+        }
+        if self.owner_handle < 0 {
+            self.owner_handle = rust_actor_bridge::resolve(&self.owner);
+        }
+        let rc = fanout_to_cpp::<M>(self.owner_handle, &self.items, &self.offsets, &self.cpp_handles);
+        self.items.clear();
+        self.offsets.truncate(1);
+        self.cpp_handles.clear();
+        rc
+    }
+}
@@ -0,0 +1,577 @@
+//! Traffic capture - records the messages crossing the bridge to a
+//! memory-mapped log, and replays a log back through the FFI
+//! (C++ reaches this module through TrafficCapture.hpp)
+//!
+//! While a capture runs, cpp_actor_send*() and rust_actor_send*() append one
+//! record per message: a timestamp, the target and sender and the raw C
+//! struct. The log is preallocated at start(), so recording is a reserve
+//! (one atomic add) and a copy; a record that does not fit is counted and
+//! dropped. When no capture runs, the bridges pay one relaxed load.
+//!
+//! Actors are recorded by name, not handle, so a log can be replayed in
+//! another run of the same program. Each name is written once, the first
+//! time an actor is seen, and records refer to it by ID.
+
+use std::collections::HashMap;
+use std::ffi::CStr;
+use std::fs::{File, OpenOptions};
+use std::os::raw::{c_char, c_int, c_void};
+use std::ptr;
+use std::sync::atomic::{AtomicI32, AtomicPtr, AtomicU32, AtomicU64, AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+use crate::actor_directory::{RUNTIME_CPP, RUNTIME_RUST};
+use crate::interop_messages::c_struct_size;
+use crate::interop_wire::SCHEMA_HASH;
+use crate::rust_actor_bridge::{DIRECT_HANDLE, MAX_DIRECT_ACTORS, MAX_HANDLES};
+
+const MAGIC: u32 = 0x4943_5031; // "ICP1"
+const VERSION: u32 = 1;
+
+const KIND_MESSAGE: u8 = 0;
+const KIND_NAME: u8 = 1;
+
+/// Log header; records follow it, each 8-byte aligned
+#[repr(C, align(64))]
+struct LogHeader {
+    magic: u32,
+    version: u32,
+    /// interop_wire::SCHEMA_HASH of the recording build
+    schema_hash: u64,
+    /// Bytes available for records
+    capacity: u64,
+    /// Bytes reserved so far (may pass capacity - those records are dropped)
+    used: AtomicU64,
+    records: AtomicU64,
+    dropped: AtomicU64,
+}
+
+/// One record. A message record carries the C struct, a name record the
+/// actor's name (target is the ID it is given, msg_type unused).
+#[repr(C)]
+struct RecordHeader {
+    /// Total bytes, header included; 0 until the record is complete
+    size: AtomicU32,
+    kind: u8,
+    /// Runtime of the target actor (RUNTIME_CPP / RUNTIME_RUST)
+    runtime: u8,
+    _pad: u16,
+    msg_type: i32,
+    /// Name IDs (-1 for no sender)
+    target: i32,
+    sender: i32,
+    /// Nanoseconds since start()
+    t_ns: u64,
+}
+
+const RECORD_HEADER: usize = std::mem::size_of::<RecordHeader>();
+const _: () = assert!(RECORD_HEADER == 32);
+
+fn record_bytes(payload: usize) -> usize {
+    (RECORD_HEADER + payload).next_multiple_of(8)
+}
+
+/// Totals of a finished capture (same layout as TrafficCapture.hpp)
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct InteropCaptureSummary {
+    pub records: u64,
+    /// Did not fit, or the type has no flat C struct (view fields)
+    pub dropped: u64,
+    pub bytes: u64,
+}
+
+/// Totals of a replay (same layout as TrafficCapture.hpp)
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct InteropReplaySummary {
+    pub sent: u64,
+    /// Target not found in this run
+    pub skipped: u64,
+    /// Rejected by the bridge (unknown type, reentrant direct call)
+    pub failed: u64,
+    pub elapsed_ns: u64,
+}
+
+// ============================================================================
+// Capture
+// ============================================================================
+
+struct Session {
+    map: sys::Mapping,
+    file: File,
+    start: Instant,
+    // First-sight name IDs per (runtime, handle), stored + 1 (0 = not seen)
+    cpp_ids: Box<[AtomicI32]>,
+    rust_ids: Box<[AtomicI32]>,
+    // Names seen by name-based sends, and the next ID
+    names: Mutex<(HashMap<(u8, String), i32>, i32)>,
+}
+
+impl Session {
+    fn header(&self) -> &LogHeader {
+        unsafe { &*(self.map.ptr as *const LogHeader) }
+    }
+
+    /// Reserve and fill one record; false if it does not fit
+    fn append(&self, kind: u8, runtime: u8, msg_type: i32, target: i32, sender: i32, payload: &[u8]) -> bool {
+        let h = self.header();
+        let size = record_bytes(payload.len());
+        let at = h.used.fetch_add(size as u64, Ordering::Relaxed);
+        if at + size as u64 > h.capacity {
+            h.dropped.fetch_add(1, Ordering::Relaxed);
+            return false;
+        }
+        let base = self.map.ptr.wrapping_add(std::mem::size_of::<LogHeader>() + at as usize);
+        unsafe {
+            let rec = &mut *(base as *mut RecordHeader);
+            rec.kind = kind;
+            rec.runtime = runtime;
+            rec.msg_type = msg_type;
+            rec.target = target;
+            rec.sender = sender;
+            rec.t_ns = self.start.elapsed().as_nanos() as u64;
+            ptr::copy_nonoverlapping(payload.as_ptr(), base.add(RECORD_HEADER), payload.len());
+            rec.size.store(size as u32, Ordering::Release);
+        }
+        h.records.fetch_add(1, Ordering::Relaxed);
+        true
+    }
+
+    /// Name ID for a name, writing its name record the first time
+    fn name_id(&self, runtime: u8, name: &str) -> i32 {
+        let mut names = self.names.lock().unwrap();
+        if let Some(&id) = names.0.get(&(runtime, name.to_string())) {
+            return id;
+        }
+        let id = names.1;
+        if !self.append(KIND_NAME, runtime, 0, id, -1, name.as_bytes()) {
+            return -1;
+        }
+        names.1 += 1;
+        names.0.insert((runtime, name.to_string()), id);
+        id
+    }
+
+    /// Name ID for a bridge handle, cached per handle after the first lookup
+    fn handle_id(&self, runtime: u8, handle: i32) -> i32 {
+        let ids = if runtime as c_int == RUNTIME_CPP { &self.cpp_ids } else { &self.rust_ids };
+        let slot = match id_slot(handle) {
+            Some(i) => &ids[i],
+            None => return -1,
+        };
+        let cached = slot.load(Ordering::Relaxed);
+        if cached > 0 {
+            return cached - 1;
+        }
+        let id = match handle_name(runtime, handle) {
+            Some(name) => self.name_id(runtime, name),
+            None => return -1,
+        };
+        if id >= 0 {
+            slot.store(id + 1, Ordering::Relaxed);
+        }
+        id
+    }
+}
+
+fn id_slot(handle: i32) -> Option<usize> {
+    if handle >= 0 && (handle as usize) < MAX_HANDLES {
+        Some(handle as usize)
+    } else if handle & DIRECT_HANDLE != 0 {
+        let i = (handle & !DIRECT_HANDLE) as usize;
+        (i < MAX_DIRECT_ACTORS).then_some(MAX_HANDLES + i)
+    } else {
+        None
+    }
+}
+
+extern "C" {
+    fn cpp_actor_name(handle: c_int) -> *const c_char;
+    fn cpp_actor_send_h(handle: c_int, sender_handle: c_int, msg_type: c_int, msg_data: *const c_void) -> c_int;
+}
+
+fn handle_name(runtime: u8, handle: i32) -> Option<&'static str> {
+    let name = if runtime as c_int == RUNTIME_CPP {
+        unsafe { cpp_actor_name(handle) }
+    } else {
+        crate::rust_actor_bridge::rust_actor_name(handle)
+    };
+    // SAFETY: bridge names live until shutdown, which stops no capture
+    c_str(name)
+}
+
+/// The other runtime - a sender lives on the far side of the bridge
+fn peer(runtime: u8) -> u8 {
+    if runtime as c_int == RUNTIME_CPP { RUNTIME_RUST as u8 } else { RUNTIME_CPP as u8 }
+}
+
+/// Nonzero while a capture runs - read by both bridges before recording
+#[no_mangle]
+pub static interop_capture_on: AtomicU32 = AtomicU32::new(0);
+
+static SESSION: AtomicPtr<Session> = AtomicPtr::new(ptr::null_mut());
+// Recorders inside a session; stop() waits for them before unmapping
+static INFLIGHT: AtomicUsize = AtomicUsize::new(0);
+static CONTROL: Mutex<()> = Mutex::new(());
+
+/// True while a capture runs (one relaxed load)
+#[inline]
+pub fn active() -> bool {
+    interop_capture_on.load(Ordering::Relaxed) != 0
+}
+
+/// Run f on the current session, if any
+fn with_session(f: impl FnOnce(&Session)) {
+    INFLIGHT.fetch_add(1, Ordering::SeqCst);
+    let session = SESSION.load(Ordering::SeqCst);
+    if !session.is_null() {
+        // SAFETY: stop() frees the session only once INFLIGHT drains
+        f(unsafe { &*session });
+    }
+    INFLIGHT.fetch_sub(1, Ordering::Release);
+}
+
+fn payload<'a>(msg_type: i32, msg_data: *const c_void) -> Option<&'a [u8]> {
+    let size = c_struct_size(msg_type)?;
+    if msg_data.is_null() {
+        return None;
+    }
+    Some(unsafe { std::slice::from_raw_parts(msg_data as *const u8, size) })
+}
+
+/// Record a handle-based send to an actor in `runtime`; the sender handle is
+/// in the other runtime
+pub fn record(runtime: c_int, handle: c_int, sender_handle: c_int, msg_type: c_int, msg_data: *const c_void) {
+    with_session(|s| {
+        let rt = runtime as u8;
+        let bytes = match payload(msg_type, msg_data) {
+            Some(b) => b,
+            None => {
+                s.header().dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        };
+        let target = s.handle_id(rt, handle);
+        if target < 0 {
+            return;
+        }
+        let sender = if sender_handle >= 0 {
+            s.handle_id(peer(rt), sender_handle)
+        } else {
+            -1
+        };
+        s.append(KIND_MESSAGE, rt, msg_type, target, sender, bytes);
+    });
+}
+
+/// Record a name-based send
+pub fn record_name(runtime: c_int, target: &str, sender: Option<&str>, msg_type: c_int, msg_data: *const c_void) {
+    with_session(|s| {
+        let rt = runtime as u8;
+        let bytes = match payload(msg_type, msg_data) {
+            Some(b) => b,
+            None => {
+                s.header().dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        };
+        let target = s.name_id(rt, target);
+        if target < 0 {
+            return;
+        }
+        let sender = sender.filter(|n| !n.is_empty()).map_or(-1, |n| s.name_id(peer(rt), n));
+        s.append(KIND_MESSAGE, rt, msg_type, target, sender, bytes);
+    });
+}
+
+/// Start capturing to `path`, preallocating `bytes` of log.
+/// Returns 0, or -1 if a capture is running or the file cannot be mapped
+pub fn start(path: &str, bytes: u64) -> i32 {
+    let _control = CONTROL.lock().unwrap();
+    if !SESSION.load(Ordering::Acquire).is_null() {
+        return -1;
+    }
+    let len = std::mem::size_of::<LogHeader>() as u64 + bytes;
+    let file = match OpenOptions::new().read(true).write(true).create(true).truncate(true).open(path) {
+        Ok(f) => f,
+        Err(_) => return -1,
+    };
+    if file.set_len(len).is_err() {
+        return -1;
+    }
+    let map = match sys::Mapping::new(&file, len as usize, true) {
+        Some(m) => m,
+        None => return -1,
+    };
+    unsafe {
+        let h = &mut *(map.ptr as *mut LogHeader);
+        h.magic = MAGIC;
+        h.version = VERSION;
+        h.schema_hash = SCHEMA_HASH;
+        h.capacity = bytes;
+    }
+    let ids = || (0..MAX_HANDLES + MAX_DIRECT_ACTORS).map(|_| AtomicI32::new(0)).collect();
+    let session = Box::new(Session {
+        map,
+        file,
+        start: Instant::now(),
+        cpp_ids: ids(),
+        rust_ids: ids(),
+        names: Mutex::new((HashMap::new(), 0)),
+    });
+    SESSION.store(Box::into_raw(session), Ordering::SeqCst);
+    interop_capture_on.store(1, Ordering::Release);
+    0
+}
+
+/// Stop the capture and trim the file to the records written.
+/// Returns the totals, or None if no capture is running
+pub fn stop() -> Option<InteropCaptureSummary> {
+    let _control = CONTROL.lock().unwrap();
+    interop_capture_on.store(0, Ordering::Release);
+    let session = SESSION.swap(ptr::null_mut(), Ordering::SeqCst);
+    if session.is_null() {
+        return None;
+    }
+    while INFLIGHT.load(Ordering::Acquire) != 0 {
+        std::hint::spin_loop();
+    }
+    let session = unsafe { Box::from_raw(session) };
+    let h = session.header();
+    let used = h.used.load(Ordering::Relaxed).min(h.capacity);
+    let summary = InteropCaptureSummary {
+        records: h.records.load(Ordering::Relaxed),
+        dropped: h.dropped.load(Ordering::Relaxed),
+        bytes: used,
+    };
+    // Record the trimmed length before unmapping
+    h.used.store(used, Ordering::Relaxed);
+    let Session { map, file, .. } = *session;
+    drop(map);
+    let _ = file.set_len(std::mem::size_of::<LogHeader>() as u64 + used);
+    Some(summary)
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+/// Send every recorded message again, through the same bridge entry points.
+/// `speed` 1.0 keeps the recorded spacing, 2.0 halves it; 0 sends as fast as
+/// possible. Targets and senders are resolved by name in this run.
+/// Returns the totals, or None if the log cannot be read or was recorded
+/// from different message definitions
+pub fn replay(path: &str, speed: f64) -> Option<InteropReplaySummary> {
+    let file = File::open(path).ok()?;
+    let len = file.metadata().ok()?.len() as usize;
+    if len < std::mem::size_of::<LogHeader>() {
+        return None;
+    }
+    let map = sys::Mapping::new(&file, len, false)?;
+    let h = unsafe { &*(map.ptr as *const LogHeader) };
+    if h.magic != MAGIC || h.version != VERSION || h.schema_hash != SCHEMA_HASH {
+        return None;
+    }
+    let end = (h.used.load(Ordering::Relaxed).min(h.capacity) as usize).min(len - std::mem::size_of::<LogHeader>());
+    let records = unsafe { map.ptr.add(std::mem::size_of::<LogHeader>()) };
+
+    // Name ID -> handle in this run (-1 if the actor is not here)
+    let mut handles: Vec<i32> = Vec::new();
+    // Records are only 8-byte aligned; messages are copied out to their
+    // own alignment (INTEROP_ALIGN types go up to a cache line)
+    let mut scratch: Vec<Aligned> = Vec::new();
+    let mut summary = InteropReplaySummary::default();
+    let start = Instant::now();
+    let mut at = 0;
+    while at + RECORD_HEADER <= end {
+        let rec = unsafe { &*(records.add(at) as *const RecordHeader) };
+        let size = rec.size.load(Ordering::Acquire) as usize;
+        if size < RECORD_HEADER || at + size > end {
+            break;  // unfinished record - the capture was cut short
+        }
+        let data = unsafe { records.add(at + RECORD_HEADER) };
+        at += size;
+
+        if rec.kind == KIND_NAME {
+            let name = unsafe { std::slice::from_raw_parts(data, size - RECORD_HEADER) };
+            let name = std::str::from_utf8(name).unwrap_or("").trim_end_matches('\0');
+            let id = rec.target as usize;
+            if handles.len() <= id {
+                handles.resize(id + 1, -1);
+            }
+            handles[id] = resolve(rec.runtime as c_int, name);
+            continue;
+        }
+
+        let handle = handles.get(rec.target as usize).copied().unwrap_or(-1);
+        if handle < 0 {
+            summary.skipped += 1;
+            continue;
+        }
+        let sender = usize::try_from(rec.sender).ok().and_then(|i| handles.get(i).copied()).unwrap_or(-1);
+        let len = size - RECORD_HEADER;
+        scratch.resize(len.div_ceil(std::mem::size_of::<Aligned>()), Aligned([0; 64]));
+        let msg = scratch.as_mut_ptr() as *mut u8;
+        unsafe { ptr::copy_nonoverlapping(data, msg, len) };
+        if speed > 0.0 {
+            let due = Duration::from_nanos((rec.t_ns as f64 / speed) as u64);
+            while start.elapsed() < due {
+                std::hint::spin_loop();
+            }
+        }
+        let rc = if rec.runtime as c_int == RUNTIME_CPP {
+            unsafe { cpp_actor_send_h(handle, sender, rec.msg_type, msg as *const c_void) }
+        } else {
+            crate::rust_actor_bridge::rust_actor_send_h(handle, sender, rec.msg_type, msg as *const c_void)
+        };
+        if rc == 0 {
+            summary.sent += 1;
+        } else {
+            summary.failed += 1;
+        }
+    }
+    summary.elapsed_ns = start.elapsed().as_nanos() as u64;
+    Some(summary)
+}
+
+#[repr(C, align(64))]
+#[derive(Clone, Copy)]
+struct Aligned([u8; 64]);
+
+fn resolve(runtime: c_int, name: &str) -> i32 {
+    if runtime == RUNTIME_CPP {
+        crate::rust_manager_ffi::resolve_cpp(name)
+    } else {
+        crate::rust_actor_bridge::resolve(name)
+    }
+}
+
+// ============================================================================
+// FFI - see TrafficCapture.hpp
+// ============================================================================
+
+fn c_str<'a>(s: *const c_char) -> Option<&'a str> {
+    if s.is_null() {
+        return None;
+    }
+    unsafe { CStr::from_ptr(s) }.to_str().ok()
+}
+
+#[no_mangle]
+pub extern "C" fn interop_capture_start(path: *const c_char, bytes: u64) -> c_int {
+    c_str(path).map_or(-1, |p| start(p, bytes))
+}
+
+#[no_mangle]
+pub extern "C" fn interop_capture_stop(out: *mut InteropCaptureSummary) -> c_int {
+    match stop() {
+        Some(summary) => {
+            if !out.is_null() {
+                unsafe { *out = summary };
+            }
+            0
+        }
+        None => -1,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn interop_capture_record(
+    runtime: c_int,
+    handle: c_int,
+    sender_handle: c_int,
+    msg_type: c_int,
+    msg_data: *const c_void,
+) {
+    record(runtime, handle, sender_handle, msg_type, msg_data)
+}
+
+#[no_mangle]
+pub extern "C" fn interop_capture_record_name(
+    runtime: c_int,
+    target: *const c_char,
+    sender: *const c_char,
+    msg_type: c_int,
+    msg_data: *const c_void,
+) {
+    if let Some(target) = c_str(target) {
+        record_name(runtime, target, c_str(sender), msg_type, msg_data)
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn interop_replay(path: *const c_char, speed: f64, out: *mut InteropReplaySummary) -> c_int {
+    match c_str(path).and_then(|p| replay(p, speed)) {
+        Some(summary) => {
+            if !out.is_null() {
+                unsafe { *out = summary };
+            }
+            0
+        }
+        None => -1,
+    }
+}
+
+// ============================================================================
+// File mapping
+// ============================================================================
+
+#[cfg(unix)]
+mod sys {
+    use std::fs::File;
+    use std::os::fd::AsRawFd;
+    use std::os::raw::{c_int, c_void};
+
+    const PROT_READ: c_int = 1;
+    const PROT_WRITE: c_int = 2;
+    const MAP_SHARED: c_int = 1;
+
+    extern "C" {
+        fn mmap(addr: *mut c_void, len: usize, prot: c_int, flags: c_int, fd: c_int, offset: i64) -> *mut c_void;
+        fn munmap(addr: *mut c_void, len: usize) -> c_int;
+    }
+
+    /// A shared mapping of a whole file, unmapped on drop
+    pub struct Mapping {
+        pub ptr: *mut u8,
+        len: usize,
+    }
+
+    // SAFETY: records are reserved atomically; each is written by one thread
+    unsafe impl Send for Mapping {}
+    unsafe impl Sync for Mapping {}
+
+    impl Mapping {
+        pub fn new(file: &File, len: usize, write: bool) -> Option<Mapping> {
+            let prot = if write { PROT_READ | PROT_WRITE } else { PROT_READ };
+            let p = unsafe { mmap(std::ptr::null_mut(), len, prot, MAP_SHARED, file.as_raw_fd(), 0) };
+            (p as isize != -1).then_some(Mapping { ptr: p as *mut u8, len })
+        }
+    }
+
+    impl Drop for Mapping {
+        fn drop(&mut self) {
+            unsafe { munmap(self.ptr as *mut c_void, self.len) };
+        }
+    }
+}
+
+#[cfg(not(unix))]
+mod sys {
+    use std::fs::File;
+
+    pub struct Mapping {
+        pub ptr: *mut u8,
+    }
+
+    unsafe impl Send for Mapping {}
+    unsafe impl Sync for Mapping {}
+
+    impl Mapping {
+        pub fn new(_file: &File, _len: usize, _write: bool) -> Option<Mapping> {
+            None
+        }
+    }
+}
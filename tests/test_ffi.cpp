@@ -1,25 +1,44 @@
 /*
- * Simple FFI test - demonstrates C++ calling Rust and vice versa
+ * FFI test - checks the bridge functions in both directions
  *
- * This test doesn't use the full actor framework - it just tests
- * that the FFI bridge functions work correctly.
+ * Test 5 calls them before any Manager is attached, so only the error
+ * paths run. Test 6 then starts both Managers - test_cpp_gate on the C++
+ * side, and the benchmark actors (bench/rust_bench.rs) on the Rust side -
+ * and checks that sends arrive, that direct calls are serialized, that
+ * bounded mailboxes refuse sends once full, that conflated messages
+ * collapse to the latest value, and that drains wait for queued messages.
+ *
+ * Every check prints its result; the test exits non-zero if any failed
+ * (make test builds and runs it).
  */
 
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
-#include "../messages/interop_messages.h"
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "actors/Actor.hpp"
+#include "InteropMessages.hpp"
+#include "InteropManager.hpp"
+#include "CppActorBridge.hpp"
+#include "InteropPool.hpp"
+#include "InteropShutdown.hpp"
+#include "InteropWire.hpp"
+#include "RustActorIF.hpp"
+#include "TrafficCapture.hpp"
 
-// Declare the Rust bridge functions
+// Rust Manager and benchmark FFI (rust/src/rust_manager_ffi.rs, bench/rust_bench.rs)
 extern "C" {
-    void rust_actor_init();
-    void rust_actor_shutdown();
-    int32_t rust_actor_send(
-        const char* actor_name,
-        const char* sender_name,
-        int32_t msg_type,
-        const void* msg_data
-    );
-    int32_t rust_actor_exists(const char* name);
+    void create_rust_manager();
+    void rust_manager_init();
+    void rust_actor_init(const void* mgr);
+    void init_cpp_actor_lookup();
+
+    uint64_t bench_rust_received(int32_t index);
+    uint64_t bench_rust_direct_received();
 }
 
 // Test callback - will be called from Rust
@@ -30,6 +49,126 @@ extern "C" void test_callback(int32_t msg_type, const void* data) {
     }
 }
 
+namespace {
+
+int g_failures = 0;
+
+// Print one result, and count it if it is not the expected one
+void check(const char* what, long long actual, long long expected) {
+    bool ok = actual == expected;
+    std::cout << (ok ? "   ok   " : "   FAIL ") << what << " = " << actual
+              << " (expected " << expected << ")" << std::endl;
+    if (!ok) g_failures++;
+}
+
+/// Spin until get() reaches target; false on timeout
+template <typename Get>
+bool wait_for(Get get, uint64_t target) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (get() < target) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/**
+ * TestGate - counts what it receives. While closed, a Ping with count HOLD
+ * blocks it until open(), so its mailbox fills up behind that Ping.
+ */
+class TestGate : public actors::Actor {
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool closed_ = false;
+
+public:
+    static constexpr int32_t HOLD = -1;
+
+    std::atomic<uint64_t> pings{0};
+    std::atomic<uint64_t> batched{0};  // items, over all batches
+    std::atomic<uint64_t> updates{0};
+    std::atomic<double> last_price{0};
+    std::atomic<bool> holding{false};
+
+    TestGate() {
+        strncpy(name, "test_cpp_gate", sizeof(name) - 1);
+        MESSAGE_HANDLER(msg::Ping, on_ping);
+        MESSAGE_HANDLER(msg::PingBatch, on_batch);
+        MESSAGE_HANDLER(msg::MarketUpdate, on_update);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = false;
+        cv_.notify_all();
+    }
+
+    void on_ping(const msg::Ping* m) noexcept {
+        if (m->count == HOLD) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            holding = true;
+            cv_.wait(lock, [&] { return !closed_; });
+            holding = false;
+            return;
+        }
+        pings.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void on_batch(const msg::PingBatch* m) noexcept {
+        batched.fetch_add(m->items.size(), std::memory_order_relaxed);
+    }
+
+    void on_update(const msg::MarketUpdate* m) noexcept {
+        updates.fetch_add(1, std::memory_order_relaxed);
+        last_price = m->price;
+    }
+};
+
+/**
+ * TestDirect - counts its direct calls, and those that overlapped another.
+ * A Ping with count REENTER makes the handler send to itself.
+ */
+class TestDirect : public interop::DirectActor {
+    std::atomic<int32_t> inside_{0};
+
+public:
+    static constexpr int32_t REENTER = -2;
+
+    int32_t handle = -1;
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> overlapped{0};
+    std::atomic<int32_t> reentered{0};  // what the send from the handler returned
+
+    void on_direct(const interop::MessageView& view, int32_t) noexcept override {
+        if (inside_.fetch_add(1) != 0) overlapped.fetch_add(1);
+        received.fetch_add(1, std::memory_order_relaxed);
+        const ::Ping* ping = view.get<msg::Ping>();
+        if (ping && ping->count == REENTER) {
+            reentered = cpp_actor_send_h(handle, -1, view.type, view.data);
+        }
+        inside_.fetch_sub(1);
+    }
+};
+
+class TestManager : public interop::InteropManager {
+public:
+    TestGate* gate;
+    TestDirect direct;
+
+    TestManager() {
+        gate = new TestGate();
+        manage(gate);
+        direct.handle = interop::register_direct_actor("test_cpp_direct", &direct);
+    }
+};
+
+} // namespace
+
 int main() {
     std::cout << "=== actors-interop FFI Test ===" << std::endl;
     std::cout << std::endl;
@@ -43,6 +182,8 @@ int main() {
     std::cout << "   sizeof(Subscribe) = " << sizeof(Subscribe) << std::endl;
     std::cout << "   sizeof(MarketUpdate) = " << sizeof(MarketUpdate) << std::endl;
     std::cout << "   sizeof(MarketDepth) = " << sizeof(MarketDepth) << std::endl;
+    std::cout << "   sizeof(OrderBook) = " << sizeof(OrderBook) << " (views - independent of depth)" << std::endl;
+    check("alignof(MarketUpdate)", alignof(MarketUpdate), 64);  // INTEROP_ALIGN(64)
     std::cout << std::endl;
 
     // Test 2: Create and serialize a Ping message
@@ -66,7 +207,7 @@ int main() {
     // Test 4: Create MarketDepth with arrays
     std::cout << "4. Creating MarketDepth with arrays:" << std::endl;
     MarketDepth depth;
-    std::strncpy(depth.symbol, "GOOG", 7);
+    depth.symbol = interop_symbol_intern("GOOG");
     depth.num_levels = 3;
     depth.bid_prices[0] = 100.0;
     depth.bid_prices[1] = 99.5;
@@ -81,7 +222,7 @@ int main() {
     depth.ask_sizes[1] = 250;
     depth.ask_sizes[2] = 350;
 
-    std::cout << "   symbol = " << depth.symbol << std::endl;
+    std::cout << "   symbol = " << depth.symbol << " (" << interop_symbol_name(depth.symbol) << ")" << std::endl;
     std::cout << "   num_levels = " << depth.num_levels << std::endl;
     for (int i = 0; i < depth.num_levels; i++) {
         std::cout << "   Level " << i << ": bid=" << depth.bid_prices[i]
@@ -91,22 +232,232 @@ int main() {
     }
     std::cout << std::endl;
 
-    // Test 5: Initialize Rust runtime and test exists
+    // Test 5: Bridge functions before any Manager is attached
     std::cout << "5. Testing Rust bridge functions:" << std::endl;
-    rust_actor_init();
-    std::cout << "   rust_actor_init() called" << std::endl;
+    rust_actor_init(nullptr);
+    std::cout << "   rust_actor_init(nullptr) called" << std::endl;
+
+    check("rust_actor_exists('nonexistent_actor')", rust_actor_exists("nonexistent_actor"), 0);
+    check("rust_actor_send() to nonexistent", rust_actor_send("nonexistent_actor", "test_sender", 1000, &ping), -1);
+
+    int handle = rust_actor_resolve("nonexistent_actor");
+    check("rust_actor_resolve('nonexistent_actor')", handle, -1);
+    check("rust_actor_send_h() with invalid handle", rust_actor_send_h(handle, -1, 1000, &ping), -1);
+
+    Ping pings[2] = {{1}, {2}};
+    check("rust_actor_send_batch() with invalid handle", rust_actor_send_batch(handle, -1, 1000, pings, 2), -1);
+
+    // The buffer is consumed even though the send fails
+    void* owned = rust_msg_alloc(1013);  // MarketDepth
+    check("rust_actor_send_owned() with invalid handle", rust_actor_send_owned(handle, -1, 1013, owned), -1);
+    check("rust_actor_set_mailbox() with invalid handle", rust_actor_set_mailbox(-1, 8, 2, 0), -1);
+    check("rust_actor_mailbox_depth() with invalid handle", rust_actor_mailbox_depth(-1), -1);
+    check("rust_actor_drain() with no Manager", rust_actor_drain(10), -1);
+    check("rust_msg_alloc(OrderBook) is null (not plain data)", rust_msg_alloc(1014) == nullptr, 1);
+
+    // Direct handles carry INTEROP_DIRECT_HANDLE (0x40000000); a missing slot is invalid
+    check("rust_actor_send_h() to unregistered direct handle", rust_actor_send_h(0x40000000 | 63, -1, 1000, &ping), -1);
+
+    check("rust_actor_factory('RustPongActor')", rust_actor_factory("RustPongActor"), 1);
+    check("rust_actor_factory('nonexistent')", rust_actor_factory("nonexistent"), -1);
+    check("register_rust_actor() with unknown factory is null", register_rust_actor("test_actor", 99, nullptr) == nullptr, 1);
+    check("register_rust_actors(nullptr, 1) is null", register_rust_actors(nullptr, 1, nullptr) == nullptr, 1);
+
+    // Nothing is published until interop_directory_build()
+    check("interop_directory_size() before build", interop_directory_size(), -1);
+    check("interop_directory_add() with unknown runtime", interop_directory_add("test_actor", 7), -1);
+
+    check("interop_ipc_import('nonexistent')", interop_ipc_import("nonexistent"), -1);
+    check("interop_ipc_resolve('nonexistent')", interop_ipc_resolve("nonexistent"), -1);
+    check("interop_wire_schema_hash() is set", interop_wire_schema_hash() != 0, 1);
+
+    check("interop_capture_stop() with no capture", interop_capture_stop(nullptr), -1);
+    check("interop_replay('/nonexistent')", interop_replay("/nonexistent", 0, nullptr), -1);
+
+    // RUNTIME_RUST = 2; the pool is never started here
+    check("interop_pool_post() with no pool", interop_pool_post(2, 0x40000000, -1, 1000, &ping), -1);
+    check("interop_pool_stop() with no pool", interop_pool_stop(0), -1);
+    check("interop_pool_worker() off the pool", interop_pool_worker(), -1);
+
+    check("interop_stats_snapshot(nullptr)", interop_stats_snapshot(nullptr), -1);
+
+    // InteropTrace: trace_id, send_ns, ffi_ns, mailbox_ns, handler_ns - a
+    // failed send drops the staged header instead of tracing the next one
+    const InteropTrace trace{1, 1, 0, 0, 0};
+    rust_actor_set_trace(&trace);
+    check("rust_actor_send_h(9999) with a trace header", rust_actor_send_h(9999, -1, 1000, &ping), -1);
+    interop_trace_set_sampling(0);
+
+    check("interop_symbol_intern('GOOG')", interop_symbol_intern("GOOG"), depth.symbol);
+    check("interop_symbol_find('nonexistent')", interop_symbol_find("nonexistent"), 0);
+    check("interop_symbol_name(0) is null", interop_symbol_name(INTEROP_NO_SYMBOL) == nullptr, 1);
+    std::cout << std::endl;
+
+    // Test 6: Sends through live Managers, as bench/main.cpp starts them
+    std::cout << "6. Testing sends between running actors:" << std::endl;
+    TestManager mgr;
+    cpp_actor_init(&mgr);
+    create_rust_manager();
+    const InteropActorSpec specs[] = {
+        {"bench_rust_sink_0", rust_actor_factory("BenchSink"), nullptr},
+        {"bench_rust_echo", rust_actor_factory("BenchEcho"), nullptr},
+        {"bench_rust_direct", rust_actor_factory("BenchDirectSink"), nullptr},
+    };
+    const void* rust_mgr = register_rust_actors(specs, 3, nullptr);
+    check("register_rust_actors() of the benchmark actors is set", rust_mgr != nullptr, 1);
+    rust_actor_init(rust_mgr);
+    init_cpp_actor_lookup();
+    mgr.init();
+    rust_manager_init();
+    mgr.build_directory();
+
+    int32_t gate = cpp_actor_resolve("test_cpp_gate");
+    int32_t sink = rust_actor_resolve("bench_rust_sink_0");
+    check("cpp_actor_resolve('test_cpp_gate') is valid", gate >= 0, 1);
+    check("rust_actor_resolve('bench_rust_sink_0') is valid", sink >= 0, 1);
+
+    // The sink counts Pings, not PingBatches, so the batch only has to be taken
+    check("rust_actor_send_h() to bench_rust_sink_0", rust_actor_send_h(sink, gate, 1000, &ping), 0);
+    check("rust_actor_send() to bench_rust_sink_0",
+          rust_actor_send("bench_rust_sink_0", "test_cpp_gate", 1000, &ping), 0);
+    check("rust_actor_send_batch() to bench_rust_sink_0", rust_actor_send_batch(sink, gate, 1000, pings, 2), 0);
+    Ping* rust_owned = static_cast<Ping*>(rust_msg_alloc(1000));
+    rust_owned->count = 3;
+    check("rust_actor_send_owned() to bench_rust_sink_0", rust_actor_send_owned(sink, gate, 1000, rust_owned), 0);
+    check("bench_rust_sink_0 received 3 Pings", wait_for([] { return bench_rust_received(0); }, 3), 1);
 
-    int exists = rust_actor_exists("nonexistent_actor");
-    std::cout << "   rust_actor_exists('nonexistent_actor') = " << exists << " (expected 0)" << std::endl;
+    check("cpp_actor_send_h() to test_cpp_gate", cpp_actor_send_h(gate, sink, 1000, &ping), 0);
+    check("cpp_actor_send() to test_cpp_gate", cpp_actor_send("test_cpp_gate", "bench_rust_sink_0", 1000, &ping), 0);
+    check("cpp_actor_send_batch() to test_cpp_gate", cpp_actor_send_batch(gate, sink, 1000, pings, 2), 0);
+    Ping* cpp_owned = static_cast<Ping*>(cpp_msg_alloc(1000));
+    cpp_owned->count = 3;
+    check("cpp_actor_send_owned() to test_cpp_gate", cpp_actor_send_owned(gate, sink, 1000, cpp_owned), 0);
+    check("test_cpp_gate received 3 Pings", wait_for([&] { return mgr.gate->pings.load(); }, 3), 1);
+    check("test_cpp_gate received a batch of 2", wait_for([&] { return mgr.gate->batched.load(); }, 2), 1);
 
-    // Try to send to non-existent actor (should return -1)
-    int result = rust_actor_send("nonexistent_actor", "test_sender", 1000, &ping);
-    std::cout << "   rust_actor_send() to nonexistent = " << result << " (expected -1)" << std::endl;
+    // Direct actors run on the sending thread; a send from their own handler is refused
+    int32_t rust_direct = rust_actor_resolve("bench_rust_direct");
+    check("rust_actor_resolve('bench_rust_direct') is direct",
+          rust_direct >= 0 && (rust_direct & INTEROP_DIRECT_HANDLE), 1);
+    check("rust_actor_send_h() to bench_rust_direct", rust_actor_send_h(rust_direct, gate, 1000, &ping), 0);
+    check("bench_rust_direct calls", bench_rust_direct_received(), 1);
 
-    rust_actor_shutdown();
-    std::cout << "   rust_actor_shutdown() called" << std::endl;
+    int32_t direct = cpp_actor_resolve("test_cpp_direct");
+    check("cpp_actor_resolve('test_cpp_direct') is its handle", direct >= 0 && direct == mgr.direct.handle, 1);
+    Ping reenter{TestDirect::REENTER};
+    check("cpp_actor_send_h() to test_cpp_direct", cpp_actor_send_h(direct, -1, 1000, &reenter), 0);
+    check("send from test_cpp_direct's own handler", mgr.direct.reentered.load(), -4);
+
+    // Calls from other threads wait for the one in progress instead
+    constexpr int SENDERS = 4;
+    constexpr int SENDS = 10000;
+    std::atomic<int32_t> failed{0};
+    std::vector<std::thread> senders;
+    for (int t = 0; t < SENDERS; t++) {
+        senders.emplace_back([&] {
+            for (int n = 0; n < SENDS; n++) {
+                if (cpp_actor_send_h(direct, -1, 1000, &ping) != 0) failed++;
+            }
+        });
+    }
+    for (auto& sender : senders) sender.join();
+    check("concurrent sends to test_cpp_direct that failed", failed.load(), 0);
+    check("test_cpp_direct calls", mgr.direct.received.load(), 1 + SENDERS * SENDS);
+    check("test_cpp_direct calls that overlapped", mgr.direct.overlapped.load(), 0);
+    std::cout << std::endl;
+
+    // Test 7: Bounded mailboxes - the held Ping counts until it is handled
+    std::cout << "7. Testing bounded mailboxes:" << std::endl;
+    check("cpp_actor_set_mailbox(test_cpp_gate, 4, 2)", cpp_actor_set_mailbox(gate, 4, 2, INTEROP_MAILBOX_REJECT), 0);
+    check("cpp_actor_set_mailbox() with low > high", cpp_actor_set_mailbox(gate, 2, 4, INTEROP_MAILBOX_REJECT), -1);
+    Ping hold{TestGate::HOLD};
+    mgr.gate->close();
+    check("cpp_actor_send_h() of the held Ping", cpp_actor_send_h(gate, -1, 1000, &hold), 0);
+    check("test_cpp_gate is held", wait_for([&] { return mgr.gate->holding.load(); }, 1), 1);
+
+    uint64_t pings_before = mgr.gate->pings.load();
+    int32_t accepted = 0;
+    int32_t rc = 0;
+    while (accepted < 10 && (rc = cpp_actor_send_h(gate, -1, 1000, &ping)) == 0) accepted++;
+    check("cpp_actor_send_h() once test_cpp_gate is full", rc, -5);
+    check("sends taken behind the held Ping", accepted, 3);
+    check("cpp_actor_mailbox_depth() when full", cpp_actor_mailbox_depth(gate), 4);
+    check("cpp_actor_send_batch() when full", cpp_actor_send_batch(gate, -1, 1000, pings, 2), -5);
+
+    mgr.gate->open();
+    check("test_cpp_gate handled the sends taken",
+          wait_for([&] { return mgr.gate->pings.load(); }, pings_before + accepted), 1);
+    check("cpp_actor_mailbox_depth() drains to 0",
+          wait_for([&] { return cpp_actor_mailbox_depth(gate) == 0; }, 1), 1);
+    check("cpp_actor_send_h() once drained", cpp_actor_send_h(gate, -1, 1000, &ping), 0);
+    check("cpp_actor_set_mailbox(test_cpp_gate, 0) removes the bound",
+          cpp_actor_set_mailbox(gate, 0, 0, INTEROP_MAILBOX_REJECT), 0);
+    check("cpp_actor_mailbox_depth() when unbounded", cpp_actor_mailbox_depth(gate), -1);
+
+    // A batch counts as one message, and the depth drains as the sink handles them
+    check("rust_actor_set_mailbox(bench_rust_sink_0, 4, 2)", rust_actor_set_mailbox(sink, 4, 2, INTEROP_MAILBOX_REJECT), 0);
+    check("rust_actor_send_h() to bounded bench_rust_sink_0", rust_actor_send_h(sink, -1, 1000, &ping), 0);
+    check("rust_actor_send_batch() to bounded bench_rust_sink_0", rust_actor_send_batch(sink, -1, 1000, pings, 2), 0);
+    check("rust_actor_mailbox_depth() drains to 0",
+          wait_for([&] { return rust_actor_mailbox_depth(sink) == 0; }, 1), 1);
+    check("rust_actor_set_mailbox(bench_rust_sink_0, 0) removes the bound",
+          rust_actor_set_mailbox(sink, 0, 0, INTEROP_MAILBOX_REJECT), 0);
+    check("rust_actor_mailbox_depth() when unbounded", rust_actor_mailbox_depth(sink), -1);
+    std::cout << std::endl;
+
+    // Test 8: Conflation - MarketUpdates for one symbol queued behind a held
+    // Ping collapse to the first and the latest
+    std::cout << "8. Testing conflation:" << std::endl;
+    mgr.gate->close();
+    check("cpp_actor_send_h() of the held Ping", cpp_actor_send_h(gate, -1, 1000, &hold), 0);
+    check("test_cpp_gate is held", wait_for([&] { return mgr.gate->holding.load(); }, 1), 1);
+
+    MarketUpdate update{};
+    update.symbol = depth.symbol;
+    int32_t update_failed = 0;
+    for (int i = 0; i < 100; i++) {
+        update.price = i;
+        update.timestamp = i;
+        if (cpp_actor_send_h(gate, -1, 1012, &update) != 0) update_failed++;
+    }
+    check("cpp_actor_send_h() of 100 MarketUpdates that failed", update_failed, 0);
+
+    mgr.gate->open();
+    check("test_cpp_gate got the latest price",
+          wait_for([&] { return mgr.gate->last_price.load() == 99.0; }, 1), 1);
+    check("MarketUpdates handled at most 2", mgr.gate->updates.load() <= 2, 1);
     std::cout << std::endl;
 
+    // Test 9: Drains return once the messages queued before them are handled
+    std::cout << "9. Testing drains:" << std::endl;
+    uint64_t sink_before = bench_rust_received(0);
+    check("rust_actor_send_h() before a drain", rust_actor_send_h(sink, -1, 1000, &ping), 0);
+    check("rust_actor_send_h() before a drain", rust_actor_send_h(sink, -1, 1000, &ping), 0);
+    check("rust_actor_drain() actors left undrained", rust_actor_drain(1000), 0);
+    check("bench_rust_sink_0 Pings handled by then", bench_rust_received(0) - sink_before, 2);
+
+    mgr.gate->close();
+    check("cpp_actor_send_h() of the held Ping", cpp_actor_send_h(gate, -1, 1000, &hold), 0);
+    pings_before = mgr.gate->pings.load();
+    check("cpp_actor_send_h() before a drain", cpp_actor_send_h(gate, -1, 1000, &ping), 0);
+    check("cpp_actor_drain() while test_cpp_gate is held", cpp_actor_drain(50) >= 1, 1);
+    mgr.gate->open();
+    check("cpp_actor_drain() actors left undrained", cpp_actor_drain(1000), 0);
+    check("test_cpp_gate Pings handled by then", mgr.gate->pings.load() - pings_before, 1);
+    std::cout << std::endl;
+
+    // Test 10: Shutdown drains, then closes both bridges
+    std::cout << "10. Testing shutdown:" << std::endl;
+    InteropShutdownConfig shutdown{INTEROP_SHUTDOWN_DRAIN, 1000, 0};
+    check("interop_shutdown() actors left undrained", interop_shutdown(&shutdown), 0);
+    check("rust_actor_send_h() after interop_shutdown()", rust_actor_send_h(sink, -1, 1000, &ping), -1);
+    check("cpp_actor_send_h() after interop_shutdown()", cpp_actor_send_h(gate, -1, 1000, &ping), -1);
+    std::cout << std::endl;
+
+    if (g_failures) {
+        std::cout << "=== " << g_failures << " check(s) FAILED ===" << std::endl;
+        return 1;
+    }
     std::cout << "=== All tests passed ===" << std::endl;
     return 0;
 }